@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FreeListCache.hpp"
+
+// Cache-aside workload: look a key up and put it on a miss. Keys come from
+// a skewed distribution over ten times the cache capacity, so hot keys hit
+// and the tail keeps evicting.
+
+struct Payload {
+	uint64_t words[4];
+	explicit Payload(uint64_t v = 0) : words{v, v, v, v} {}
+};
+
+// The usual hand-rolled LRU: every hit relinks a std::list node, every
+// eviction frees one and allocates another
+class StdLRU {
+public:
+	explicit StdLRU(size_t capacity) : capacity(capacity) {
+		index.reserve(capacity);
+	}
+
+	Payload* get(uint64_t key) {
+		auto found = index.find(key);
+		if (found == index.end()) return nullptr;
+
+		order.splice(order.begin(), order, found->second);
+		return &found->second->second;
+	}
+
+	void put(uint64_t key, const Payload& value) {
+		if (order.size() == capacity) {
+			index.erase(order.back().first);
+			order.pop_back();
+		}
+		order.emplace_front(key, value);
+		index[key] = order.begin();
+	}
+
+private:
+	size_t capacity;
+	std::list<std::pair<uint64_t, Payload>> order;
+	std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Payload>>::iterator> index;
+};
+
+volatile uint64_t sink;
+
+std::vector<uint64_t> makeKeys(size_t ops, size_t keySpace)
+{
+	std::mt19937_64 rng(7);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+	std::vector<uint64_t> keys(ops);
+	for (uint64_t& key : keys) {
+		key = static_cast<uint64_t>(keySpace * std::pow(unit(rng), 3.0)) * 0x9E3779B97F4A7C15ull;
+	}
+	return keys;
+}
+
+template <typename Cache>
+void run(const char* name, size_t capacity, const std::vector<uint64_t>& keys)
+{
+	Cache cache(capacity);
+	size_t hits = 0;
+	uint64_t sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t key : keys) {
+		if (Payload* value = cache.get(key)) {
+			sum += value->words[0];
+			hits++;
+		} else {
+			cache.put(key, Payload(key));
+		}
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << name << ',' << capacity << ',' << keys.size() << ','
+		<< static_cast<long long>(keys.size() / seconds) << ','
+		<< static_cast<double>(hits) / keys.size() << std::endl;
+
+	sink = sum;
+}
+
+int main(int argc, char** argv)
+{
+	size_t ops = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	size_t maxCapacity = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+	std::cout << "cache,capacity,ops,ops_per_sec,hit_rate" << std::endl;
+
+	for (size_t capacity = 1000; capacity <= maxCapacity; capacity *= 10) {
+		std::vector<uint64_t> keys = makeKeys(ops, capacity * 10);
+
+		run<StdLRU>("std::list+unordered_map", capacity, keys);
+		run<FreeListCache<uint64_t, Payload>>("FreeListCache/lru", capacity, keys);
+		run<FreeListCache<uint64_t, Payload, FreeListEviction::clock>>("FreeListCache/clock", capacity, keys);
+	}
+
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "FreeList.hpp"
+#include "ConcurrentFreeListPool.hpp"
+
+// Multi-threaded node churn: every thread keeps a working set of nodes and
+// repeatedly releases a random one and allocates a replacement.
+
+struct Payload {
+	long long value;
+	explicit Payload(long long v) : value(v) {}
+};
+
+constexpr size_t workingSet = 1024;
+
+template <typename Handle, typename Allocate, typename Release, typename Read>
+long long churn(size_t ops, unsigned seed, Allocate allocate, Release release, Read read)
+{
+	std::mt19937 rng(seed);
+	std::vector<Handle> held;
+	held.reserve(workingSet);
+
+	long long sum = 0;
+	for (size_t i = 0; i < workingSet; ++i) {
+		held.push_back(allocate(static_cast<long long>(i)));
+	}
+
+	for (size_t i = 0; i < ops; ++i) {
+		size_t k = rng() % workingSet;
+		sum += read(held[k]);
+		release(held[k]);
+		held[k] = allocate(static_cast<long long>(i));
+	}
+
+	for (Handle& h : held) {
+		release(h);
+	}
+	return sum;
+}
+
+template <typename Body>
+double run_threads(unsigned threads, size_t ops, Body body)
+{
+	std::vector<std::thread> workers;
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned t = 0; t < threads; ++t) {
+		workers.emplace_back([&body, t, ops] { body(t, ops); });
+	}
+	for (std::thread& w : workers) {
+		w.join();
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return static_cast<double>(threads) * static_cast<double>(ops) / elapsed.count();
+}
+
+double bench_concurrent_pool(unsigned threads, size_t ops)
+{
+	ConcurrentFreeListPool<Payload> pool(threads * workingSet * 2);
+
+	return run_threads(threads, ops, [&pool](unsigned t, size_t n) {
+		ConcurrentFreeListPool<Payload>::Cache cache(pool);
+		churn<size_t>(n, t,
+			[&](long long v) { return cache.allocate(v); },
+			[&](size_t idx) { cache.release(idx); },
+			[&](size_t idx) { return pool[idx].value; });
+	});
+}
+
+double bench_locked_freelist(unsigned threads, size_t ops)
+{
+	FreeList<Payload> list;
+	std::mutex mutex;
+	using Handle = FreeList<Payload>::iterator;
+
+	return run_threads(threads, ops, [&](unsigned t, size_t n) {
+		churn<Handle>(n, t,
+			[&](long long v) {
+				std::lock_guard<std::mutex> lock(mutex);
+				return list.emplace(list.end(), v);
+			},
+			[&](Handle it) {
+				std::lock_guard<std::mutex> lock(mutex);
+				list.erase(it);
+			},
+			[&](Handle it) {
+				std::lock_guard<std::mutex> lock(mutex);
+				return it->value;
+			});
+	});
+}
+
+double bench_locked_list(unsigned threads, size_t ops)
+{
+	std::list<Payload> list;
+	std::mutex mutex;
+	using Handle = std::list<Payload>::iterator;
+
+	return run_threads(threads, ops, [&](unsigned t, size_t n) {
+		churn<Handle>(n, t,
+			[&](long long v) {
+				std::lock_guard<std::mutex> lock(mutex);
+				return list.emplace(list.end(), v);
+			},
+			[&](Handle it) {
+				std::lock_guard<std::mutex> lock(mutex);
+				list.erase(it);
+			},
+			[&](Handle it) {
+				std::lock_guard<std::mutex> lock(mutex);
+				return it->value;
+			});
+	});
+}
+
+int main(int argc, char** argv)
+{
+	size_t ops = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+	unsigned maxThreads = (argc > 2)
+		? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10))
+		: std::max(1u, std::thread::hardware_concurrency());
+
+	std::cout << "container,threads,ops_per_sec" << std::endl;
+
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+		std::cout << "ConcurrentFreeListPool," << threads << "," << bench_concurrent_pool(threads, ops) << std::endl;
+		std::cout << "mutex+FreeList," << threads << "," << bench_locked_freelist(threads, ops) << std::endl;
+		std::cout << "mutex+std::list," << threads << "," << bench_locked_list(threads, ops) << std::endl;
+	}
+
+	return 0;
+}
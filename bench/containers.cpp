@@ -0,0 +1,287 @@
+#include <papiCPP.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "FreeList.hpp"
+#include "FreeListAllocators.hpp"
+
+// FreeList against std::list, std::vector and std::deque over a grid of
+// element sizes and container sizes. FreeList also runs on
+// FreeListHugePageAllocator, whose effect shows in the tlb_dm column.
+// Every operation runs inside its own event_set region and prints one CSV
+// row, so runs can be diffed over time.
+//
+//   container_bench [max_elements] [max_bytes]
+//
+// Sizes go 1K, 10K, ... up to max_elements (default 1M, 100M is the
+// largest the grid is meant for). Cases whose elements alone would take
+// more than max_bytes (default 4 GiB) are skipped.
+
+using Events = papi::event_set<
+	PAPI_TOT_CYC,
+	PAPI_TOT_INS,
+	PAPI_L1_DCM,
+	PAPI_L2_DCM,
+	PAPI_L3_TCM,
+	PAPI_TLB_DM
+>;
+
+// Padding after the key, empty for 4 byte elements
+template <size_t Bytes>
+struct Padding {
+	std::array<char, Bytes> payload{};
+};
+
+template <>
+struct Padding<0> {};
+
+template <size_t Bytes>
+struct Element : Padding<Bytes - sizeof(uint32_t)> {
+	static_assert(Bytes >= sizeof(uint32_t), "Element holds at least its key");
+
+	uint32_t key;
+
+	Element() : key(0) {}
+	explicit Element(uint32_t k) : key(k) {}
+
+	bool operator==(const Element& other) const { return key == other.key; }
+	bool operator<(const Element& other) const { return key < other.key; }
+};
+
+template <typename Container>
+struct Traits;
+
+template <typename T>
+struct Traits<std::list<T>> {
+	static constexpr const char* name = "std::list";
+	static constexpr bool hasPushFront = true;
+};
+
+template <typename T>
+struct Traits<std::vector<T>> {
+	static constexpr const char* name = "std::vector";
+	static constexpr bool hasPushFront = false;
+};
+
+template <typename T>
+struct Traits<std::deque<T>> {
+	static constexpr const char* name = "std::deque";
+	static constexpr bool hasPushFront = true;
+};
+
+template <typename T>
+struct Traits<FreeList<T>> {
+	static constexpr const char* name = "FreeList";
+	static constexpr bool hasPushFront = true;
+};
+
+template <typename T>
+struct Traits<FreeList<T, FreeListHugePageAllocator<T>>> {
+	static constexpr const char* name = "FreeList/hugepage";
+	static constexpr bool hasPushFront = true;
+};
+
+// Operations whose spelling differs between the containers
+
+template <typename T>
+void sortAll(std::list<T>& c) { c.sort(); }
+
+template <typename T, typename A>
+void sortAll(FreeList<T, A>& c) { c.sort(); }
+
+template <typename Container>
+void sortAll(Container& c) { std::sort(c.begin(), c.end()); }
+
+template <typename T, typename Predicate>
+void eraseIf(std::list<T>& c, Predicate pred) { c.remove_if(pred); }
+
+template <typename T, typename A, typename Predicate>
+void eraseIf(FreeList<T, A>& c, Predicate pred) { c.remove_if(pred); }
+
+template <typename Container, typename Predicate>
+void eraseIf(Container& c, Predicate pred) { c.erase(std::remove_if(c.begin(), c.end(), pred), c.end()); }
+
+template <typename T, typename A>
+bool findKey(FreeList<T, A>& c, const T& value) { return c.find(value) != c.end(); }
+
+template <typename Container, typename T>
+bool findKey(Container& c, const T& value) { return std::find(c.begin(), c.end(), value) != c.end(); }
+
+template <typename Container>
+typename Container::iterator randomPosition(Container& c, std::mt19937& rng)
+{
+	auto pos = c.begin();
+	std::advance(pos, c.empty() ? 0 : rng() % c.size());
+	return pos;
+}
+
+// Keeps results observable so the optimizer cannot drop the work
+volatile uint64_t sink;
+
+class Runner {
+public:
+	Runner(Events& events) : events(events) {}
+
+	template <typename Container>
+	void run(size_t elements)
+	{
+		using T = typename Container::value_type;
+		std::mt19937 rng(static_cast<unsigned>(elements));
+
+		// Random-position work walks to its position, cap it so large sizes
+		// stay near 1e8 steps per case
+		size_t randomOps = std::min<size_t>(1000, std::max<size_t>(1, 100000000 / elements));
+
+		Container c;
+		measure<Container>(elements, "push_back", [&] {
+			for (size_t i = 0; i < elements; ++i) {
+				c.push_back(T(static_cast<uint32_t>(rng())));
+			}
+		});
+
+		if constexpr (Traits<Container>::hasPushFront) {
+			Container front;
+			measure<Container>(elements, "push_front", [&] {
+				for (size_t i = 0; i < elements; ++i) {
+					front.push_front(T(static_cast<uint32_t>(i)));
+				}
+			});
+		}
+
+		measure<Container>(elements, "iterate", [&] {
+			sink = sumKeys(c);
+		});
+
+		measure<Container>(elements, "random_insert", [&] {
+			for (size_t i = 0; i < randomOps; ++i) {
+				c.insert(randomPosition(c, rng), T(static_cast<uint32_t>(rng())));
+			}
+		});
+
+		measure<Container>(elements, "random_erase", [&] {
+			for (size_t i = 0; i < randomOps && !c.empty(); ++i) {
+				c.erase(randomPosition(c, rng));
+			}
+		});
+
+		measure<Container>(elements, "find", [&] {
+			// The last element's key, so the search scans everything before it
+			sink = findKey(c, c.back());
+		});
+
+		measure<Container>(elements, "sort", [&] {
+			sortAll(c);
+		});
+
+		measure<Container>(elements, "churn", [&] {
+			// Drop about half of the elements and refill, four times over
+			for (uint32_t round = 0; round < 4; ++round) {
+				size_t before = c.size();
+				eraseIf(c, [round](const T& x) { return (x.key & 1) == (round & 1); });
+				for (size_t i = c.size(); i < before; ++i) {
+					c.push_back(T(static_cast<uint32_t>(rng())));
+				}
+			}
+		});
+
+		measure<Container>(elements, "iterate_after_churn", [&] {
+			sink = sumKeys(c);
+		});
+
+		measure<Container>(elements, "copy", [&] {
+			Container copy(c);
+			sink = copy.size();
+		});
+
+		measure<Container>(elements, "move", [&] {
+			Container moved(std::move(c));
+			c = std::move(moved);
+			sink = c.size();
+		});
+	}
+
+private:
+	template <typename Container>
+	static uint64_t sumKeys(const Container& c)
+	{
+		uint64_t sum = 0;
+		for (const auto& x : c) {
+			sum += x.key;
+		}
+		return sum;
+	}
+
+	template <typename Container, typename Work>
+	void measure(size_t elements, const char* operation, Work work)
+	{
+		events.start_counters();
+		work();
+		events.stop_counters();
+
+		std::cout << Traits<Container>::name << ','
+			<< sizeof(typename Container::value_type) << ','
+			<< elements << ','
+			<< operation << ','
+			<< events.get<PAPI_TOT_CYC>().counter() << ','
+			<< events.get<PAPI_TOT_INS>().counter() << ','
+			<< events.get<PAPI_L1_DCM>().counter() << ','
+			<< events.get<PAPI_L2_DCM>().counter() << ','
+			<< events.get<PAPI_L3_TCM>().counter() << ','
+			<< events.get<PAPI_TLB_DM>().counter() << std::endl;
+
+		events.reset_counters();
+	}
+
+	Events& events;
+};
+
+template <size_t Bytes>
+void runSize(Runner& runner, size_t elements, size_t maxBytes)
+{
+	static_assert(sizeof(Element<Bytes>) == Bytes, "Element has no padding of its own");
+	if (elements > maxBytes / Bytes) return;
+
+	runner.run<std::list<Element<Bytes>>>(elements);
+	runner.run<std::vector<Element<Bytes>>>(elements);
+	runner.run<std::deque<Element<Bytes>>>(elements);
+	runner.run<FreeList<Element<Bytes>>>(elements);
+	runner.run<FreeList<Element<Bytes>, FreeListHugePageAllocator<Element<Bytes>>>>(elements);
+}
+
+int main(int argc, char** argv)
+{
+	size_t maxElements = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	size_t maxBytes = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : (size_t(4) << 30);
+
+	try {
+		Events events;
+		Runner runner(events);
+
+		std::cout << "container,element_bytes,elements,operation,"
+			<< "cycles,instructions,l1_dcm,l2_dcm,l3_tcm,tlb_dm" << std::endl;
+
+		for (size_t elements = 1000; elements <= maxElements; elements *= 10) {
+			runSize<4>(runner, elements, maxBytes);
+			runSize<16>(runner, elements, maxBytes);
+			runSize<64>(runner, elements, maxBytes);
+			runSize<256>(runner, elements, maxBytes);
+		}
+
+	} catch (const std::runtime_error& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
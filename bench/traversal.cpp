@@ -0,0 +1,126 @@
+#include <papiCPP.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FreeList.hpp"
+
+// Cache behaviour of walking a FreeList in list order. Each layout is walked
+// with plain iterators and with the prefetching for_each / for_each_chunk
+// at a few distances, squaring every element like main.cpp does.
+//
+//   sequential  list order matches storage order (push_back only)
+//   shuffled    every element inserted in front of a random earlier one,
+//               so consecutive nodes land in unrelated slots
+//   sorted      the shuffled list after sort(), which moves values but
+//               keeps the links, so the walk is as scattered as before
+
+using List = FreeList<uint32_t>;
+
+using Events = papi::event_set<
+	PAPI_TOT_CYC,
+	PAPI_L1_DCM,
+	PAPI_L2_DCM,
+	PAPI_L3_TCM
+>;
+
+List makeSequential(size_t nodes, std::mt19937& rng)
+{
+	List list;
+	list.reserve(nodes);
+	for (size_t i = 0; i < nodes; ++i) {
+		list.push_back(static_cast<uint32_t>(rng()));
+	}
+	return list;
+}
+
+List makeShuffled(size_t nodes, std::mt19937& rng)
+{
+	List list;
+	list.reserve(nodes);
+
+	std::vector<List::iterator> positions;
+	positions.reserve(nodes);
+	positions.push_back(list.insert(list.end(), static_cast<uint32_t>(rng())));
+
+	for (size_t i = 1; i < nodes; ++i) {
+		List::iterator pos = positions[rng() % positions.size()];
+		positions.push_back(list.insert(pos, static_cast<uint32_t>(rng())));
+	}
+	return list;
+}
+
+template <typename Walk>
+void measure(Events& events, const std::string& layout, const std::string& method, List& list, Walk walk)
+{
+	events.start_counters();
+	walk(list);
+	events.stop_counters();
+
+	std::cout << layout << ',' << method << ',' << list.size() << ','
+		<< events.get<PAPI_TOT_CYC>().counter() << ','
+		<< events.get<PAPI_L1_DCM>().counter() << ','
+		<< events.get<PAPI_L2_DCM>().counter() << ','
+		<< events.get<PAPI_L3_TCM>().counter() << std::endl;
+
+	events.reset_counters();
+}
+
+void run(Events& events, const std::string& layout, List& list)
+{
+	measure(events, layout, "iterator", list, [](List& l) {
+		for (uint32_t& i : l) {
+			i = i * i;
+		}
+	});
+
+	for (size_t distance : {4, 16, 64}) {
+		measure(events, layout, "for_each/" + std::to_string(distance), list, [distance](List& l) {
+			l.for_each([](uint32_t& i) { i = i * i; }, distance);
+		});
+	}
+
+	for (size_t chunk : {16, 64, 256}) {
+		measure(events, layout, "for_each_chunk/" + std::to_string(chunk), list, [chunk](List& l) {
+			l.for_each_chunk([](uint32_t* const* elements, size_t count) {
+				for (size_t k = 0; k < count; ++k) {
+					*elements[k] = *elements[k] * *elements[k];
+				}
+			}, chunk);
+		});
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t nodes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+	try {
+		Events events;
+		std::mt19937 rng(42);
+
+		std::cout << "layout,method,nodes,cycles,l1_dcm,l2_dcm,l3_tcm" << std::endl;
+
+		{
+			List list = makeSequential(nodes, rng);
+			run(events, "sequential", list);
+		}
+
+		{
+			List list = makeShuffled(nodes, rng);
+			run(events, "shuffled", list);
+
+			list.sort();
+			run(events, "sorted", list);
+		}
+
+	} catch (const std::runtime_error& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
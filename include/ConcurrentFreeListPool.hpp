@@ -0,0 +1,313 @@
+#ifndef CONCURRENTFREELISTPOOL_HPP
+#define CONCURRENTFREELISTPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// Node pool that many threads can allocate from and release into at once.
+// Storage grows in fixed-size chunks that are never moved or freed while the
+// pool lives, so a node index stays valid from allocation until release.
+// Freed slots go onto a lock-free stack of batches whose head carries a tag
+// that is bumped on every update, which rules out ABA on pop.
+//
+// Threads that allocate or release often should go through a Cache, which
+// keeps a private batch of slots and touches the shared stack only once per
+// batch. Linking nodes into lists is left to the caller.
+template<typename T, size_t ChunkBits = 12>
+class ConcurrentFreeListPool {
+public:
+    static constexpr size_t chunkSize = size_t(1) << ChunkBits;
+    static constexpr size_t batchSize = 64;
+
+private:
+    static constexpr uint32_t emptySlot = UINT32_MAX;
+    static constexpr uint32_t liveSlot = UINT32_MAX - 1;
+    static constexpr size_t chunkMask = chunkSize - 1;
+
+    struct Chunk {
+        std::atomic<uint32_t> next_free[chunkSize];   // Chain inside a batch, liveSlot while allocated
+        std::atomic<uint32_t> next_batch[chunkSize];  // Stack link, only read at a batch head
+        alignas(T) unsigned char storage[chunkSize * sizeof(T)];
+
+        Chunk() {
+            for (size_t i = 0; i < chunkSize; ++i) {
+                next_free[i].store(emptySlot, std::memory_order_relaxed);
+                next_batch[i].store(emptySlot, std::memory_order_relaxed);
+            }
+        }
+
+        T* slot(size_t offset) {
+            return std::launder(reinterpret_cast<T*>(storage) + offset);
+        }
+    };
+
+    // Packs a slot index with a modification tag
+    static uint64_t pack(uint32_t index, uint32_t tag) {
+        return (uint64_t(tag) << 32) | index;
+    }
+
+    static uint32_t indexOf(uint64_t word) { return uint32_t(word); }
+    static uint32_t tagOf(uint64_t word) { return uint32_t(word >> 32); }
+
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks;
+    size_t maxChunks;
+    std::atomic<size_t> slots_;        // Fresh slots handed out so far
+    std::atomic<uint64_t> freeBatches; // Tagged head of the batch stack
+
+    Chunk* chunkFor(size_t index) const {
+        return chunks[index >> ChunkBits].load(std::memory_order_acquire);
+    }
+
+    std::atomic<uint32_t>& nextFree(size_t index) const {
+        return chunkFor(index)->next_free[index & chunkMask];
+    }
+
+    std::atomic<uint32_t>& nextBatch(size_t index) const {
+        return chunkFor(index)->next_batch[index & chunkMask];
+    }
+
+    // Makes sure the chunks backing [first, first + count) exist; racing
+    // threads may each build one, only the first to publish it wins
+    void ensureChunks(size_t first, size_t count) {
+        for (size_t c = first >> ChunkBits; c <= (first + count - 1) >> ChunkBits; ++c) {
+            if (chunks[c].load(std::memory_order_acquire) != nullptr) continue;
+
+            Chunk* fresh = new Chunk();
+            Chunk* expected = nullptr;
+            if (!chunks[c].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+                delete fresh;
+            }
+        }
+    }
+
+    // Reserves count never-used slots, throwing once the pool is exhausted
+    size_t takeFresh(size_t count) {
+        size_t first = slots_.fetch_add(count, std::memory_order_relaxed);
+        if (first + count > maxChunks * chunkSize) {
+            throw std::bad_alloc();
+        }
+        ensureChunks(first, count);
+        return first;
+    }
+
+    // Publishes a chain of free slots linked through next_free
+    void pushBatch(uint32_t first) {
+        uint64_t head = freeBatches.load(std::memory_order_relaxed);
+        do {
+            nextBatch(first).store(indexOf(head), std::memory_order_relaxed);
+        } while (!freeBatches.compare_exchange_weak(
+                     head, pack(first, tagOf(head) + 1),
+                     std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Takes one chain of free slots, or emptySlot if there is none
+    uint32_t popBatch() {
+        uint64_t head = freeBatches.load(std::memory_order_acquire);
+        while (indexOf(head) != emptySlot) {
+            // A stale read of next_batch is harmless, the tag makes the CAS fail
+            uint32_t next = nextBatch(indexOf(head)).load(std::memory_order_relaxed);
+            if (freeBatches.compare_exchange_weak(
+                    head, pack(next, tagOf(head) + 1),
+                    std::memory_order_acquire, std::memory_order_acquire)) {
+                return indexOf(head);
+            }
+        }
+        return emptySlot;
+    }
+
+    template <typename... Args>
+    T& construct(size_t index, Args&&... args) {
+        T* slot = chunkFor(index)->slot(index & chunkMask);
+        ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+        nextFree(index).store(liveSlot, std::memory_order_relaxed);
+        return *slot;
+    }
+
+    void destroy(size_t index) {
+        std::destroy_at(chunkFor(index)->slot(index & chunkMask));
+    }
+
+public:
+    // Per-thread front end. A Cache must only be used by one thread at a
+    // time and must not outlive its pool; it hands unused slots back to the
+    // shared stack when flushed or destroyed.
+    class Cache {
+    public:
+        explicit Cache(ConcurrentFreeListPool& pool)
+            : pool(&pool), freeHead(emptySlot), freeCount(0), freshNext(0), freshEnd(0) {}
+
+        Cache(const Cache&) = delete;
+        Cache& operator=(const Cache&) = delete;
+
+        ~Cache() {
+            flush();
+        }
+
+        template <typename... Args>
+        size_t allocate(Args&&... args) {
+            if (freeHead == emptySlot && freshNext == freshEnd && !refill()) {
+                freshNext = pool->takeFresh(batchSize);
+                freshEnd = freshNext + batchSize;
+            }
+
+            if (freeHead != emptySlot) {
+                // The link is overwritten once the slot is live, read it first
+                size_t index = freeHead;
+                uint32_t after = pool->nextFree(index).load(std::memory_order_relaxed);
+                pool->construct(index, std::forward<Args>(args)...);
+                freeHead = after;
+                freeCount--;
+                return index;
+            }
+
+            size_t index = freshNext;
+            pool->construct(index, std::forward<Args>(args)...);
+            freshNext++;
+            return index;
+        }
+
+        void release(size_t index) {
+            pool->destroy(index);
+            pool->nextFree(index).store(freeHead, std::memory_order_relaxed);
+            freeHead = uint32_t(index);
+
+            if (++freeCount >= batchSize) {
+                publish();
+            }
+        }
+
+        // Returns every slot held by this cache to the shared stack
+        void flush() {
+            while (freshNext != freshEnd) {
+                pool->nextFree(freshNext).store(freeHead, std::memory_order_relaxed);
+                freeHead = uint32_t(freshNext++);
+            }
+            if (freeHead != emptySlot) {
+                publish();
+            }
+        }
+
+    private:
+        // Tries to take a batch of freed slots from the shared stack
+        bool refill() {
+            uint32_t batch = pool->popBatch();
+            if (batch == emptySlot) return false;
+
+            // Count the adopted chain so the next publish stays at batchSize.
+            // flush() can publish longer chains, anything past batchSize goes
+            // back to the shared stack.
+            size_t count = 1;
+            uint32_t last = batch;
+            uint32_t rest = pool->nextFree(last).load(std::memory_order_relaxed);
+            while (rest != emptySlot && count < batchSize) {
+                last = rest;
+                rest = pool->nextFree(last).load(std::memory_order_relaxed);
+                count++;
+            }
+            if (rest != emptySlot) {
+                pool->nextFree(last).store(emptySlot, std::memory_order_relaxed);
+                pool->pushBatch(rest);
+            }
+
+            freeHead = batch;
+            freeCount = count;
+            return true;
+        }
+
+        void publish() {
+            pool->pushBatch(freeHead);
+            freeHead = emptySlot;
+            freeCount = 0;
+        }
+
+        ConcurrentFreeListPool* pool;
+        uint32_t freeHead;   // Private chain of free slots
+        size_t freeCount;
+        size_t freshNext;    // Never-used slots reserved by this cache
+        size_t freshEnd;
+    };
+
+    // maxCapacity bounds the number of slots and sizes the chunk directory
+    explicit ConcurrentFreeListPool(size_t maxCapacity = size_t(1) << 26)
+        : chunks(), maxChunks(0), slots_(0), freeBatches(pack(emptySlot, 0)) {
+        // Whole chunks only, rounded down at the top so that no slot index
+        // reaches the liveSlot and emptySlot sentinels
+        if (maxCapacity > liveSlot) {
+            maxCapacity = liveSlot;
+        }
+        maxChunks = std::min<size_t>((maxCapacity + chunkSize - 1) >> ChunkBits, liveSlot >> ChunkBits);
+        chunks.reset(new std::atomic<Chunk*>[maxChunks]);
+        for (size_t c = 0; c < maxChunks; ++c) {
+            chunks[c].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentFreeListPool(const ConcurrentFreeListPool&) = delete;
+    ConcurrentFreeListPool& operator=(const ConcurrentFreeListPool&) = delete;
+
+    // Must not run concurrently with any other use of the pool
+    ~ConcurrentFreeListPool() {
+        for (size_t c = 0; c < maxChunks; ++c) {
+            Chunk* chunk = chunks[c].load(std::memory_order_acquire);
+            if (chunk == nullptr) continue;
+
+            if constexpr (!std::is_trivially_destructible<T>::value) {
+                for (size_t i = 0; i < chunkSize; ++i) {
+                    if (chunk->next_free[i].load(std::memory_order_relaxed) == liveSlot) {
+                        std::destroy_at(chunk->slot(i));
+                    }
+                }
+            }
+            delete chunk;
+        }
+    }
+
+    // Uncached access, one shared-stack operation per call
+    template <typename... Args>
+    size_t allocate(Args&&... args) {
+        uint32_t batch = popBatch();
+        if (batch == emptySlot) {
+            size_t index = takeFresh(1);
+            construct(index, std::forward<Args>(args)...);
+            return index;
+        }
+
+        uint32_t rest = nextFree(batch).load(std::memory_order_relaxed);
+        if (rest != emptySlot) {
+            pushBatch(rest);
+        }
+
+        try {
+            construct(batch, std::forward<Args>(args)...);
+        } catch (...) {
+            nextFree(batch).store(emptySlot, std::memory_order_relaxed);
+            pushBatch(batch);
+            throw;
+        }
+        return batch;
+    }
+
+    void release(size_t index) {
+        destroy(index);
+        nextFree(index).store(emptySlot, std::memory_order_relaxed);
+        pushBatch(uint32_t(index));
+    }
+
+    T& operator[](size_t index) {
+        return *chunkFor(index)->slot(index & chunkMask);
+    }
+
+    const T& operator[](size_t index) const {
+        return *chunkFor(index)->slot(index & chunkMask);
+    }
+
+    size_t max_capacity() const noexcept { return maxChunks * chunkSize; }
+};
+
+#endif
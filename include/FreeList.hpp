@@ -4,78 +4,232 @@
 #include <vector>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
 #include <cstddef>
 #include <cstdint>
 #include <execution>
 
-template<typename T>
+#include "FreeListPool.hpp"
+
+template<typename T, typename Allocator, typename Instrumentation>
 class FreeList {
 private:
-    // Structure of Arrays (SoA) approach
-    std::vector<size_t> next_indices;  // Linked list "next" pointers
-    std::vector<size_t> prev_indices;  // Linked list "prev" pointers
-    std::vector<size_t> next_free;     // Free list management
-    std::vector<T> data;               // Actual data values
-    
+    // Node storage, either owned by this list (created on first use) or
+    // shared with other lists constructed from the same FreeListPool
+    FreeListPool<T, Allocator, Instrumentation>* pool;
+    std::unique_ptr<FreeListPool<T, Allocator, Instrumentation>> ownedPool;
+    Allocator allocator_;  // Given to the owned pool when it is created
+
     // List endpoints and size
     size_t head;
     size_t tail;
-    size_t freeHead;
     size_t size_;
 
+    // Traversal limits, larger requests are clamped
+    static constexpr size_t maxPrefetchDistance = 64;
+    static constexpr size_t maxChunkSize = 256;
+
     // Helper methods
-    template <typename U>
-    size_t allocateNode(U&& value) {
-        size_t index;
+    bool sharesPool() const {
+        return pool != nullptr && !ownedPool;
+    }
 
-        if (freeHead != SIZE_MAX) {
-            // Reuse a freed node
-            index = freeHead;
-            freeHead = next_free[freeHead];
-            data[index] = std::forward<U>(value);
-            next_indices[index] = SIZE_MAX;
-            prev_indices[index] = SIZE_MAX;
-        } else {
-            // Allocate new node
-            index = data.size();
-            data.emplace_back(std::forward<U>(value));
-            next_indices.push_back(SIZE_MAX);
-            prev_indices.push_back(SIZE_MAX);
-            next_free.push_back(SIZE_MAX);
+    FreeListPool<T, Allocator, Instrumentation>& nodes() {
+        if (pool == nullptr) {
+            ownedPool = std::make_unique<FreeListPool<T, Allocator, Instrumentation>>(allocator_);
+            pool = ownedPool.get();
         }
+        return *pool;
+    }
 
+    template <typename... Args>
+    size_t allocateNode(Args&&... args) {
+        size_t index = nodes().allocateNode(std::forward<Args>(args)...);
         size_++;
         return index;
     }
-    
-    void remove(size_t index) {
-        if (index >= data.size()) return;
 
-        // Update linked list pointers
-        size_t nextIndex = next_indices[index];
-        size_t prevIndex = prev_indices[index];
+    // Links the detached chain first..last (inclusive) in front of pos,
+    // SIZE_MAX meaning the end of the list
+    void linkNodes(size_t pos, size_t first, size_t last) {
+        size_t before = (pos == SIZE_MAX) ? tail : pool->prev_indices[pos];
+
+        pool->prev_indices[first] = before;
+        pool->next_indices[last] = pos;
 
-        if (prevIndex == SIZE_MAX) {
-            head = nextIndex;
+        if (before == SIZE_MAX) {
+            head = first;
         } else {
-            next_indices[prevIndex] = nextIndex;
+            pool->next_indices[before] = first;
         }
 
-        if (nextIndex == SIZE_MAX) {
-            tail = prevIndex;
+        if (pos == SIZE_MAX) {
+            tail = last;
         } else {
-            prev_indices[nextIndex] = prevIndex;
+            pool->prev_indices[pos] = last;
         }
+    }
+
+    // Detaches the chain first..last (inclusive) without freeing it
+    void unlinkNodes(size_t first, size_t last) {
+        size_t before = pool->prev_indices[first];
+        size_t after = pool->next_indices[last];
 
-        // Add to free list
-        next_free[index] = freeHead;
-        freeHead = index;
+        if (before == SIZE_MAX) {
+            head = after;
+        } else {
+            pool->next_indices[before] = after;
+        }
+
+        if (after == SIZE_MAX) {
+            tail = before;
+        } else {
+            pool->prev_indices[after] = before;
+        }
+    }
+
+    void remove(size_t index) {
+        if (pool == nullptr || index >= pool->slots_) return;
+
+        unlinkNodes(index, index);
+        pool->releaseNode(index);
 
         size_--;
     }
 
+    // Links count new elements in front of pos in one batch, make(slot)
+    // placement-constructing each of them. Returns the first new node.
+    template <typename Make>
+    size_t insertRun(size_t pos, size_t count, Make make) {
+        if (count == 0) return pos;
+
+        auto [first, last] = nodes().allocateRun(count, make);
+        linkNodes(pos, first, last);
+        size_ += count;
+        return first;
+    }
+
+    // Frees the linked span first..last (inclusive) of this list
+    void removeRun(size_t first, size_t last) {
+        unlinkNodes(first, last);
+        size_ -= pool->releaseChain(first, last);
+    }
+
+    // Moves the element at index of another list (drawing from a different
+    // pool) into a fresh, unlinked node of this list
+    size_t adoptNode(FreeList& other, size_t index) {
+        size_t newIndex = allocateNode(std::move(other.pool->data[index]));
+        other.remove(index);
+        return newIndex;
+    }
+
+    // Visits this list's slots in storage order: through the pool's live
+    // bitmap when the pool is private, along the chain when it is shared.
+    // Callbacks follow FreeListPool::scanLive.
+    template <typename Block, typename One>
+    void scanElements(Block block, One one) const {
+        if (pool == nullptr) return;
+
+        if (sharesPool()) {
+            for (size_t curr = head; curr != SIZE_MAX; curr = pool->next_indices[curr]) {
+                if (one(curr)) return;
+            }
+            return;
+        }
+
+        pool->scanLive(block, one);
+    }
+
+    // Walks the chain distance nodes ahead of visit(index), prefetching each
+    // payload as the lead reaches it, so payload misses overlap the
+    // dependent loads through next_indices
+    template <typename Visit>
+    void walkAhead(size_t distance, Visit visit) const {
+        size_t ring[maxPrefetchDistance];
+        distance = std::clamp<size_t>(distance, 1, maxPrefetchDistance);
+
+        size_t lead = head;
+        size_t pending = 0;
+        for (; pending < distance && lead != SIZE_MAX; ++pending) {
+            __builtin_prefetch(pool->data + lead);
+            ring[pending] = lead;
+            lead = pool->next_indices[lead];
+        }
+
+        for (size_t slot = 0; pending != 0; slot = (slot + 1 == distance) ? 0 : slot + 1) {
+            size_t curr = ring[slot];
+            if (lead != SIZE_MAX) {
+                __builtin_prefetch(pool->data + lead);
+                ring[slot] = lead;
+                lead = pool->next_indices[lead];
+            } else {
+                pending--;
+            }
+            visit(curr);
+        }
+    }
+
+    // Gathers up to chunk element pointers along the chain, prefetching each
+    // payload, before handing them to visit(elements, count)
+    template <typename Pointer, typename Visit>
+    void walkChunks(Pointer values, size_t chunk, Visit visit) const {
+        Pointer elements[maxChunkSize];
+        chunk = std::clamp<size_t>(chunk, 1, maxChunkSize);
+
+        for (size_t curr = head; curr != SIZE_MAX;) {
+            size_t count = 0;
+            for (; count < chunk && curr != SIZE_MAX; ++count) {
+                elements[count] = values + curr;
+                __builtin_prefetch(elements[count]);
+                curr = pool->next_indices[curr];
+            }
+            visit(elements, count);
+        }
+    }
+
+    size_t findAnyIndex(const T& value) const {
+        const T* values = pool ? pool->data : nullptr;
+        size_t found = SIZE_MAX;
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                bool hit = false;
+                for (size_t i = first; i < last; ++i) {
+                    hit |= static_cast<bool>(values[i] == value);
+                }
+                if (!hit) return false;
+
+                for (size_t i = first; found == SIZE_MAX; ++i) {
+                    if (values[i] == value) found = i;
+                }
+                return true;
+            },
+            [&](size_t i) {
+                if (values[i] == value) {
+                    found = i;
+                    return true;
+                }
+                return false;
+            });
+
+        return found;
+    }
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
+    using instrumentation_type = Instrumentation;
+    using pool_type = FreeListPool<T, Allocator, Instrumentation>;
+    using handle_type = FreeListHandle;
+
+    static constexpr size_t default_prefetch_distance = 16;
+    static constexpr size_t default_chunk_size = 64;
 
     class Iterator {
         friend class FreeList;
@@ -102,23 +256,23 @@ public:
         Iterator& operator=(Iterator&&) noexcept = default;
 
         reference operator*() {
-            return list->data[index];
+            return list->pool->data[index];
         }
 
         reference operator*() const {
-            return list->data[index];
+            return list->pool->data[index];
         }
 
         pointer operator->() {
-            return &list->data[index];
+            return &list->pool->data[index];
         }
 
         pointer operator->() const {
-            return &list->data[index];
+            return &list->pool->data[index];
         }
 
         Iterator& operator++() {
-            index = list->next_indices[index];
+            index = list->pool->next_indices[index];
             return *this;
         }
 
@@ -132,7 +286,7 @@ public:
             if (index == SIZE_MAX) {
                 index = list->tail;
             } else {
-                index = list->prev_indices[index];
+                index = list->pool->prev_indices[index];
             }
             return *this;
         }
@@ -187,15 +341,15 @@ public:
         ConstIterator& operator=(ConstIterator&&) noexcept = default;
 
         reference operator*() const {
-            return list->data[index];
+            return list->pool->data[index];
         }
 
         pointer operator->() const {
-            return &list->data[index];
+            return &list->pool->data[index];
         }
 
         ConstIterator& operator++() {
-            index = list->next_indices[index];
+            index = list->pool->next_indices[index];
             return *this;
         }
 
@@ -209,7 +363,7 @@ public:
             if (index == SIZE_MAX) {
                 index = list->tail;
             } else {
-                index = list->prev_indices[index];
+                index = list->pool->prev_indices[index];
             }
             return *this;
         }
@@ -243,22 +397,28 @@ public:
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     // Constructors
-    FreeList() : next_indices(), prev_indices(), next_free(), data(), 
-                 head(SIZE_MAX), tail(SIZE_MAX), freeHead(SIZE_MAX), size_(0) {}
+    FreeList() : FreeList(Allocator()) {}
 
-    FreeList(size_t count) : FreeList() {
-        reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            emplace_back(T{});
-        }
+    explicit FreeList(const Allocator& alloc)
+        : pool(nullptr), ownedPool(), allocator_(alloc), head(SIZE_MAX), tail(SIZE_MAX), size_(0) {}
+
+    // Draws nodes from a pool shared with other lists; the pool must
+    // outlive the list
+    explicit FreeList(pool_type& sharedPool) : FreeList(sharedPool.get_allocator()) {
+        pool = &sharedPool;
+    }
+
+    FreeList(size_t count, const Allocator& alloc = Allocator()) : FreeList(alloc) {
+        insertRun(SIZE_MAX, count, [](T* slot) {
+            ::new (static_cast<void*>(slot)) T();
+        });
     }
 
     template <typename U>
-    FreeList(size_t count, U&& value) : FreeList() {
-        reserve(count);
-        for (size_t i = 0; i < count; ++i) {
-            emplace_back(std::forward<U>(value));
-        }
+    FreeList(size_t count, U&& value, const Allocator& alloc = Allocator()) : FreeList(alloc) {
+        insertRun(SIZE_MAX, count, [&value](T* slot) {
+            ::new (static_cast<void*>(slot)) T(value);
+        });
     }
 
     template <typename Iterator>
@@ -268,11 +428,7 @@ public:
         typename std::enable_if<!std::is_same<typename std::iterator_traits<Iterator>::value_type, T>::value>::type* = nullptr)
         : FreeList()
     {
-        auto n = std::distance(first, last);
-        reserve(n);
-        for (auto it = first; it != last; ++it) {
-            emplace_back(*it);
-        }
+        insert(end(), first, last);
     }
     
     template <typename Iterator>
@@ -282,67 +438,87 @@ public:
         typename std::enable_if<std::is_same<typename std::iterator_traits<Iterator>::value_type, T>::value>::type* = nullptr)
         : FreeList()
     {
-        auto n = std::distance(first, last);
-        reserve(n);
-        for (auto it = first; it != last; ++it) {
-            emplace_back(*it);
-        }
+        insert(end(), first, last);
     }
 
-    FreeList(std::initializer_list<T> init) : FreeList() {
-        reserve(init.size());
-        for (const auto& value : init) {
-            emplace_back(value);
-        }
+    FreeList(std::initializer_list<T> init, const Allocator& alloc = Allocator()) : FreeList(alloc) {
+        insert(end(), init.begin(), init.end());
     }
 
-    ~FreeList() = default;
+    ~FreeList() {
+        if (sharesPool()) {
+            clear();
+        }
+    }
 
-    // Copy and move operations
-    FreeList(const FreeList& other) 
-        : next_indices(other.next_indices), prev_indices(other.prev_indices), 
-          next_free(other.next_free), data(other.data),
-          head(other.head), tail(other.tail), freeHead(other.freeHead), size_(other.size_) {}
+    // Copy and move operations. A copy draws from the same shared pool as
+    // its source; a list owning its pool is copied slot for slot. The
+    // allocator travels with the pool, so assignment and swap of private
+    // pools exchange allocators too.
+    FreeList(const FreeList& other)
+        : FreeList(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_)) {
+        if (other.sharesPool()) {
+            pool = other.pool;
+            for (const T& value : other) {
+                emplace_back(value);
+            }
+        } else if (other.pool != nullptr) {
+            ownedPool.reset(new pool_type(*other.pool));
+            pool = ownedPool.get();
+            head = other.head;
+            tail = other.tail;
+            size_ = other.size_;
+        }
+    }
 
     FreeList(FreeList&& other) noexcept
-        : next_indices(std::move(other.next_indices)), prev_indices(std::move(other.prev_indices)), 
-          next_free(std::move(other.next_free)), data(std::move(other.data)),
-          head(other.head), tail(other.tail), freeHead(other.freeHead), size_(other.size_) {
-        other.head = other.tail = other.freeHead = SIZE_MAX;
+        : pool(other.pool), ownedPool(std::move(other.ownedPool)), allocator_(other.allocator_),
+          head(other.head), tail(other.tail), size_(other.size_) {
+        if (ownedPool) {
+            other.pool = nullptr;
+        }
+        other.head = other.tail = SIZE_MAX;
         other.size_ = 0;
     }
 
+    // Assignment keeps the pool this list draws from
     FreeList& operator=(const FreeList& other) {
         if (this != &other) {
-            next_indices = other.next_indices;
-            prev_indices = other.prev_indices;
-            next_free = other.next_free;
-            data = other.data;
-            head = other.head;
-            tail = other.tail;
-            freeHead = other.freeHead;
-            size_ = other.size_;
+            if (sharesPool() || other.sharesPool()) {
+                clear();
+                for (const T& value : other) {
+                    emplace_back(value);
+                }
+            } else {
+                FreeList copy(other);
+                swap(copy);
+            }
         }
         return *this;
     }
 
-    FreeList& operator=(FreeList&& other) noexcept {
+    FreeList& operator=(FreeList&& other) {
         if (this != &other) {
-            next_indices = std::move(other.next_indices);
-            prev_indices = std::move(other.prev_indices);
-            next_free = std::move(other.next_free);
-            data = std::move(other.data);
-            head = other.head;
-            tail = other.tail;
-            freeHead = other.freeHead;
-            size_ = other.size_;
-            
-            other.head = other.tail = other.freeHead = SIZE_MAX;
-            other.size_ = 0;
+            if (pool == other.pool || (!sharesPool() && !other.sharesPool())) {
+                FreeList moved(std::move(other));
+                swap(moved);
+            } else {
+                clear();
+                splice(end(), other);
+            }
         }
         return *this;
     }
 
+    allocator_type get_allocator() const {
+        return pool ? pool->get_allocator() : allocator_;
+    }
+
+    // The policy object of the pool this list draws from
+    Instrumentation& instrumentation() {
+        return nodes().instrumentation();
+    }
+
     // Iterator methods
     iterator begin() { return iterator(this, head); }
     const_iterator begin() const { return const_iterator(this, head); }
@@ -361,113 +537,63 @@ public:
     const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
 
     // Element access
-    const T& front() const { return data[head]; }
-    const T& back() const { return data[tail]; }
-    T& front() { return data[head]; }
-    T& back() { return data[tail]; }
+    const T& front() const { return pool->data[head]; }
+    const T& back() const { return pool->data[tail]; }
+    T& front() { return pool->data[head]; }
+    T& back() { return pool->data[tail]; }
 
-    // Capacity
+    // Capacity, reported for the whole pool when it is shared
     bool empty() const noexcept { return head == SIZE_MAX && tail == SIZE_MAX; }
     size_t size() const noexcept { return size_; }
-    size_t capacity() const noexcept { return data.capacity(); }
+    size_t capacity() const noexcept { return pool ? pool->capacity() : 0; }
 
     void reserve(size_t count) {
-        data.reserve(count);
-        next_indices.reserve(count);
-        prev_indices.reserve(count);
-        next_free.reserve(count);
+        nodes().reserve(count);
     }
 
     void shrink_to_fit() {
-        data.shrink_to_fit();
-        next_indices.shrink_to_fit();
-        prev_indices.shrink_to_fit();
-        next_free.shrink_to_fit();
+        if (pool != nullptr) {
+            pool->shrink_to_fit();
+        }
     }
 
     void clear() {
-        head = tail = freeHead = SIZE_MAX;
+        if (sharesPool()) {
+            if (head != SIZE_MAX) {
+                pool->releaseChain(head, tail);
+            }
+        } else if (pool != nullptr) {
+            pool->reset();
+        }
+        head = tail = SIZE_MAX;
         size_ = 0;
-        data.clear();
-        next_indices.clear();
-        prev_indices.clear();
-        next_free.clear();
     }
 
     // Modifiers
     template <typename U>
     void push_front(U&& value) {
         size_t index = allocateNode(std::forward<U>(value));
-        if (head != SIZE_MAX) {
-            next_indices[index] = head;
-            prev_indices[head] = index;
-        }
-        head = index;
-        if (tail == SIZE_MAX) {
-            tail = index;
-        }
+        linkNodes(head, index, index);
     }
 
     template <typename U>
     void push_back(U&& value) {
         size_t index = allocateNode(std::forward<U>(value));
-        if (head == SIZE_MAX) {
-            head = index;
-            tail = index;
-        } else {
-            next_indices[tail] = index;
-            prev_indices[index] = tail;
-            tail = index;
-        }
+        linkNodes(SIZE_MAX, index, index);
     }
 
     template<class... Args>
     iterator emplace(const_iterator pos, Args&&... args) {
-        T value(std::forward<Args>(args)...);
-        
-        if (pos == end()) {
-            size_t index = allocateNode(std::move(value));
-            if (tail != SIZE_MAX) {
-                next_indices[tail] = index;
-                prev_indices[index] = tail;
-            } else {
-                head = index;
-            }
-            tail = index;
-            return iterator(this, index);
-        }
-
-        size_t currentIndex = pos.getIndex();
-        size_t newIndex = allocateNode(std::move(value));
-
-        next_indices[newIndex] = currentIndex;
-        prev_indices[newIndex] = prev_indices[currentIndex];
-
-        if (prev_indices[currentIndex] != SIZE_MAX) {
-            next_indices[prev_indices[currentIndex]] = newIndex;
-        } else {
-            head = newIndex;
-        }
-
-        prev_indices[currentIndex] = newIndex;
-        return iterator(this, newIndex);
+        size_t index = allocateNode(std::forward<Args>(args)...);
+        linkNodes(pos.getIndex(), index, index);
+        return iterator(this, index);
     }
 
     template<typename... Args>
     T& emplace_back(Args&&... args) {
-        T value(std::forward<Args>(args)...);
-        size_t index = allocateNode(std::move(value));
-        
-        if (head == SIZE_MAX) {
-            head = index;
-            tail = index;
-        } else {
-            next_indices[tail] = index;
-            prev_indices[index] = tail;
-            tail = index;
-        }
-        
-        return data[index];
+        size_t index = allocateNode(std::forward<Args>(args)...);
+        linkNodes(SIZE_MAX, index, index);
+        return pool->data[index];
     }
 
     iterator erase(iterator pos) {
@@ -485,16 +611,14 @@ public:
     }
 
     iterator erase(iterator first, iterator last) {
-        while (first != last) {
-            first = erase(first);
-        }
-        return last;
+        return erase(const_iterator(first), const_iterator(last));
     }
 
+    // Unlinks the span once and frees it as a single chain
     iterator erase(const_iterator first, const_iterator last) {
-        while (first != last) {
-            const_iterator current = first++;
-            remove(current.getIndex());
+        if (first != last) {
+            size_t lastIdx = (last.getIndex() == SIZE_MAX) ? tail : pool->prev_indices[last.getIndex()];
+            removeRun(first.getIndex(), lastIdx);
         }
         return iterator(this, last.getIndex());
     }
@@ -502,34 +626,9 @@ public:
     // Fixed insert functions
     template <typename U>
     iterator insert(const_iterator it, U&& value) {
-        if (!(it == end())) {
-            size_t currentIndex = it.getIndex();
-            size_t newIndex = allocateNode(std::forward<U>(value));
-            
-            next_indices[newIndex] = currentIndex;
-            prev_indices[newIndex] = prev_indices[currentIndex];
-
-            if (prev_indices[currentIndex] != SIZE_MAX) {
-                next_indices[prev_indices[currentIndex]] = newIndex;
-            } else {
-                head = newIndex;
-            }
-            
-            prev_indices[currentIndex] = newIndex;
-            return iterator(this, newIndex);
-        } else {
-            size_t newIndex = allocateNode(std::forward<U>(value));
-            
-            if (tail != SIZE_MAX) {
-                next_indices[tail] = newIndex;
-                prev_indices[newIndex] = tail;
-            } else {
-                head = newIndex;
-            }
-            
-            tail = newIndex;
-            return iterator(this, newIndex);
-        }
+        size_t newIndex = allocateNode(std::forward<U>(value));
+        linkNodes(it.getIndex(), newIndex, newIndex);
+        return iterator(this, newIndex);
     }
 
     // Add explicit implementation for const T& 
@@ -552,6 +651,17 @@ public:
     template<class InputIt>
     iterator insert(const_iterator pos, InputIt first, InputIt last) {
         if (first == last) return iterator(this, pos.getIndex());
+
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+            // Known length, build the whole run at once
+            size_t count = static_cast<size_t>(std::distance(first, last));
+            size_t firstNewIndex = insertRun(pos.getIndex(), count, [&first](T* slot) {
+                ::new (static_cast<void*>(slot)) T(*first);
+                ++first;
+            });
+            return iterator(this, firstNewIndex);
+        }
         
         size_t firstNewIndex = SIZE_MAX;
         size_t currentIndex = pos.getIndex();
@@ -563,28 +673,7 @@ public:
                 firstNewIndex = newIndex;
             }
             
-            if (currentIndex != SIZE_MAX) {
-                // Insert before currentIndex
-                next_indices[newIndex] = currentIndex;
-                prev_indices[newIndex] = prev_indices[currentIndex];
-                
-                if (prev_indices[currentIndex] != SIZE_MAX) {
-                    next_indices[prev_indices[currentIndex]] = newIndex;
-                } else {
-                    head = newIndex;
-                }
-                
-                prev_indices[currentIndex] = newIndex;
-            } else {
-                // Insert at end
-                if (tail != SIZE_MAX) {
-                    next_indices[tail] = newIndex;
-                    prev_indices[newIndex] = tail;
-                } else {
-                    head = newIndex;
-                }
-                tail = newIndex;
-            }
+            linkNodes(currentIndex, newIndex, newIndex);
         }
         
         return iterator(this, firstNewIndex);
@@ -605,39 +694,477 @@ public:
     }
 
     void swap(FreeList& other) noexcept {
+        std::swap(pool, other.pool);
+        std::swap(ownedPool, other.ownedPool);
+        std::swap(allocator_, other.allocator_);
         std::swap(head, other.head);
         std::swap(tail, other.tail);
-        std::swap(freeHead, other.freeHead);
         std::swap(size_, other.size_);
-        next_indices.swap(other.next_indices);
-        prev_indices.swap(other.prev_indices);
-        next_free.swap(other.next_free);
-        data.swap(other.data);
+    }
+
+    // List operations. Between lists drawing from the same pool these only
+    // relink indices; otherwise elements are moved into this list's pool.
+    // Unlike std::list, splice and merge from another list invalidate every
+    // iterator to the transferred elements: iterators belong to a list, not
+    // a node, and a splice into an empty list may swap pools outright.
+    // Handles stay valid on a shared pool and when the pools are swapped.
+    void splice(const_iterator pos, FreeList& other) {
+        if (&other == this || other.empty()) return;
+
+        if (empty() && !sharesPool() && !other.sharesPool()) {
+            // Both pools are private, take over the other one wholesale
+            swap(other);
+            return;
+        }
+
+        splice(pos, other, other.begin(), other.end());
+    }
+
+    void splice(const_iterator pos, FreeList&& other) {
+        splice(pos, other);
+    }
+
+    void splice(const_iterator pos, FreeList& other, const_iterator it) {
+        const_iterator next = it;
+        ++next;
+        if (pos == it || pos == next) return;
+        splice(pos, other, it, next);
+    }
+
+    void splice(const_iterator pos, FreeList&& other, const_iterator it) {
+        splice(pos, other, it);
+    }
+
+    void splice(const_iterator pos, FreeList& other, const_iterator first, const_iterator last) {
+        if (first == last) return;
+
+        if (pool == other.pool) {
+            size_t firstIdx = first.getIndex();
+            size_t lastIdx = (last.getIndex() == SIZE_MAX) ? other.tail : pool->prev_indices[last.getIndex()];
+
+            if (&other != this) {
+                // Only a partial range needs counting, the whole list is O(1)
+                size_t count = other.size_;
+                if (firstIdx != other.head || lastIdx != other.tail) {
+                    count = 1;
+                    for (size_t curr = firstIdx; curr != lastIdx; curr = pool->next_indices[curr]) {
+                        count++;
+                    }
+                }
+                other.size_ -= count;
+                size_ += count;
+            }
+
+            other.unlinkNodes(firstIdx, lastIdx);
+            linkNodes(pos.getIndex(), firstIdx, lastIdx);
+        } else {
+            size_t at = pos.getIndex();
+            while (first != last) {
+                size_t index = (first++).getIndex();
+                size_t newIndex = adoptNode(other, index);
+                linkNodes(at, newIndex, newIndex);
+            }
+        }
+    }
+
+    void splice(const_iterator pos, FreeList&& other, const_iterator first, const_iterator last) {
+        splice(pos, other, first, last);
+    }
+
+    template <typename Compare = std::less<T>>
+    void merge(FreeList& other, Compare comp = Compare()) {
+        if (&other == this) return;
+
+        size_t curr = head;
+        while (other.head != SIZE_MAX) {
+            // Find the first node of this list that sorts after other's front
+            while (curr != SIZE_MAX && !comp(other.pool->data[other.head], pool->data[curr])) {
+                curr = pool->next_indices[curr];
+            }
+
+            if (curr == SIZE_MAX) {
+                splice(end(), other);
+                return;
+            }
+
+            if (pool == other.pool) {
+                // Relink the whole run of other's nodes that sorts before curr
+                size_t first = other.head;
+                size_t last = first;
+                size_t count = 1;
+                while (pool->next_indices[last] != SIZE_MAX &&
+                       comp(pool->data[pool->next_indices[last]], pool->data[curr])) {
+                    last = pool->next_indices[last];
+                    count++;
+                }
+
+                other.unlinkNodes(first, last);
+                other.size_ -= count;
+                linkNodes(curr, first, last);
+                size_ += count;
+            } else {
+                size_t newIndex = adoptNode(other, other.head);
+                linkNodes(curr, newIndex, newIndex);
+            }
+        }
+    }
+
+    template <typename Compare = std::less<T>>
+    void merge(FreeList&& other, Compare comp = Compare()) {
+        merge(other, comp);
+    }
+
+    // One pass; each run of matching nodes is unlinked and freed at once
+    template <typename Predicate>
+    size_t remove_if(Predicate pred) {
+        size_t before = size_;
+        size_t curr = head;
+
+        while (curr != SIZE_MAX) {
+            if (!pred(pool->data[curr])) {
+                curr = pool->next_indices[curr];
+                continue;
+            }
+
+            size_t runLast = curr;
+            while (pool->next_indices[runLast] != SIZE_MAX &&
+                   pred(pool->data[pool->next_indices[runLast]])) {
+                runLast = pool->next_indices[runLast];
+            }
+
+            size_t next = pool->next_indices[runLast];
+            removeRun(curr, runLast);
+            curr = next;
+        }
+
+        return before - size_;
+    }
+
+    template <typename BinaryPredicate = std::equal_to<T>>
+    size_t unique(BinaryPredicate pred = BinaryPredicate()) {
+        if (size_ <= 1) return 0;
+
+        size_t removed = 0;
+        size_t kept = head;
+        for (size_t curr = pool->next_indices[head]; curr != SIZE_MAX;) {
+            size_t next = pool->next_indices[curr];
+            if (pred(pool->data[kept], pool->data[curr])) {
+                remove(curr);
+                removed++;
+            } else {
+                kept = curr;
+            }
+            curr = next;
+        }
+        return removed;
+    }
+
+    void reverse() noexcept {
+        for (size_t curr = head; curr != SIZE_MAX;) {
+            size_t next = pool->next_indices[curr];
+            std::swap(pool->next_indices[curr], pool->prev_indices[curr]);
+            curr = next;
+        }
+        std::swap(head, tail);
+    }
+
+    // Generational handles. A handle names one element until it is erased;
+    // erasing bumps the slot's generation, so a stale handle stops resolving
+    // instead of aliasing whatever reuses the slot. Handles are checked
+    // against the pool: on a shared pool only use them with the issuing
+    // list. Assignment and swap invalidate handles as they do iterators.
+    handle_type handle(const_iterator it) const {
+        size_t index = it.getIndex();
+        if (index > UINT32_MAX) {
+            throw std::length_error("FreeList slot index does not fit in a handle");
+        }
+        return handle_type{uint32_t(index), pool->generations[index]};
+    }
+
+    bool valid(handle_type h) const noexcept {
+        return pool != nullptr && h.index < pool->slots_ &&
+               pool->generations[h.index] == h.generation;
+    }
+
+    T* get(handle_type h) noexcept {
+        return valid(h) ? pool->data + h.index : nullptr;
+    }
+
+    const T* get(handle_type h) const noexcept {
+        return valid(h) ? pool->data + h.index : nullptr;
+    }
+
+    // Returns end() for a stale handle
+    iterator iterator_to(handle_type h) noexcept {
+        return iterator(this, valid(h) ? size_t(h.index) : SIZE_MAX);
+    }
+
+    const_iterator iterator_to(handle_type h) const noexcept {
+        return const_iterator(this, valid(h) ? size_t(h.index) : SIZE_MAX);
+    }
+
+    // Returns false and does nothing for a stale handle
+    bool erase(handle_type h) {
+        if (!valid(h)) return false;
+        remove(h.index);
+        return true;
+    }
+
+    // Snapshots, for trivially copyable T. save() writes the list and its
+    // private pool slot for slot; open_mapped() maps such a file and uses
+    // the arrays in place, so loading costs page faults on first touch
+    // rather than a rebuild. A read_only list must not be modified (doing
+    // so faults); a copy_on_write list can be, leaving the file untouched,
+    // and moves to allocated storage the first time it grows. A mapped file
+    // must not be truncated or rewritten in place while it is open; save()
+    // replaces the file by renaming a new one over it, so saving back to
+    // the path a list was opened from is safe.
+    void save(const std::string& path) const {
+        if (sharesPool()) {
+            throw std::logic_error("FreeList::save needs a list that owns its pool");
+        }
+
+        if (pool == nullptr) {
+            pool_type(allocator_).saveSnapshot(path, SIZE_MAX, SIZE_MAX, 0);
+        } else {
+            pool->saveSnapshot(path, head, tail, size_);
+        }
+    }
+
+    static FreeList open_mapped(const std::string& path, FreeListMapMode mode = FreeListMapMode::copy_on_write) {
+        static_assert(std::is_trivially_copyable<T>::value, "FreeList snapshots need a trivially copyable type");
+
+        FreeListSnapshot::Mapping mapping = FreeListSnapshot::map(path, mode, sizeof(T), alignof(T));
+        const FreeListSnapshot::Header& header = *mapping.header;
+
+        FreeList list;
+        try {
+            if ((header.head >= header.slots && header.head != SIZE_MAX) ||
+                (header.tail >= header.slots && header.tail != SIZE_MAX) ||
+                header.size != header.live) {
+                throw std::runtime_error("FreeList snapshot " + path + " has corrupt list state");
+            }
+            list.ownedPool = std::make_unique<pool_type>(list.allocator_);
+        } catch (...) {
+            FreeListSnapshot::unmap(mapping.base, mapping.length);
+            throw;
+        }
+
+        list.pool = list.ownedPool.get();
+        list.pool->adoptMapping(mapping);
+        list.head = header.head;
+        list.tail = header.tail;
+        list.size_ = header.size;
+        return list;
     }
 
     // Find
     iterator find(const T& value) {
+        size_t visited = 0;
         for (iterator it = begin(); it != end(); ++it) {
+            visited++;
             if (*it == value) {
+                pool->instrumentation().on_find(visited);
                 return it;
             }
         }
+        if (pool != nullptr) {
+            pool->instrumentation().on_find(visited);
+        }
         return end();
     }
 
+    // Prefetching traversal in list order. for_each runs distance nodes ahead
+    // of f along the chain; for_each_chunk gathers up to chunk elements
+    // before calling f(elements, count) with an array of pointers to them.
+    // Either way payload loads no longer wait on each step of the chain.
+    // f must not insert or erase elements of this list.
+    template <typename Function>
+    Function for_each(Function f, size_t distance = default_prefetch_distance) {
+        T* values = pool ? pool->data : nullptr;
+        walkAhead(distance, [&](size_t i) { f(values[i]); });
+        return f;
+    }
+
+    template <typename Function>
+    Function for_each(Function f, size_t distance = default_prefetch_distance) const {
+        const T* values = pool ? pool->data : nullptr;
+        walkAhead(distance, [&](size_t i) { f(values[i]); });
+        return f;
+    }
+
+    template <typename Function>
+    Function for_each_chunk(Function f, size_t chunk = default_chunk_size) {
+        T* values = pool ? pool->data : nullptr;
+        walkChunks(values, chunk, [&](T* const* elements, size_t count) { f(elements, count); });
+        return f;
+    }
+
+    template <typename Function>
+    Function for_each_chunk(Function f, size_t chunk = default_chunk_size) const {
+        const T* values = pool ? pool->data : nullptr;
+        walkChunks(values, chunk, [&](const T* const* elements, size_t count) { f(elements, count); });
+        return f;
+    }
+
+    // Unordered queries. These visit elements in storage order instead of
+    // list order, streaming over the data array when the pool is private
+    // so that dense runs vectorize.
+    bool contains(const T& value) const {
+        return findAnyIndex(value) != SIZE_MAX;
+    }
+
+    // Returns some element equal to value, not necessarily the first
+    iterator find_any(const T& value) {
+        return iterator(this, findAnyIndex(value));
+    }
+
+    const_iterator find_any(const T& value) const {
+        return const_iterator(this, findAnyIndex(value));
+    }
+
+    size_t count(const T& value) const {
+        return count_if([&value](const T& x) { return x == value; });
+    }
+
+    template <typename Predicate>
+    size_t count_if(Predicate pred) const {
+        const T* values = pool ? pool->data : nullptr;
+        size_t n = 0;
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                size_t run = 0;
+                for (size_t i = first; i < last; ++i) {
+                    run += pred(values[i]) ? 1 : 0;
+                }
+                n += run;
+                return false;
+            },
+            [&](size_t i) {
+                n += pred(values[i]) ? 1 : 0;
+                return false;
+            });
+
+        return n;
+    }
+
+    template <typename Function>
+    Function for_each_unordered(Function f) {
+        T* values = pool ? pool->data : nullptr;
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    f(values[i]);
+                }
+                return false;
+            },
+            [&](size_t i) {
+                f(values[i]);
+                return false;
+            });
+
+        return f;
+    }
+
+    template <typename Function>
+    Function for_each_unordered(Function f) const {
+        const T* values = pool ? pool->data : nullptr;
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    f(values[i]);
+                }
+                return false;
+            },
+            [&](size_t i) {
+                f(values[i]);
+                return false;
+            });
+
+        return f;
+    }
+
+    // Reductions, the list must not be empty for min and max
+    template <typename Compare = std::less<T>>
+    T min_unordered(Compare comp = Compare()) const {
+        const T* values = pool->data;
+        T best = values[head];
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    best = comp(values[i], best) ? values[i] : best;
+                }
+                return false;
+            },
+            [&](size_t i) {
+                best = comp(values[i], best) ? values[i] : best;
+                return false;
+            });
+
+        return best;
+    }
+
+    template <typename Compare = std::less<T>>
+    T max_unordered(Compare comp = Compare()) const {
+        const T* values = pool->data;
+        T best = values[head];
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    best = comp(best, values[i]) ? values[i] : best;
+                }
+                return false;
+            },
+            [&](size_t i) {
+                best = comp(best, values[i]) ? values[i] : best;
+                return false;
+            });
+
+        return best;
+    }
+
+    template <typename Result = T>
+    Result sum_unordered(Result init = Result()) const {
+        const T* values = pool ? pool->data : nullptr;
+
+        scanElements(
+            [&](size_t first, size_t last) {
+                Result run = Result();
+                for (size_t i = first; i < last; ++i) {
+                    run += values[i];
+                }
+                init += run;
+                return false;
+            },
+            [&](size_t i) {
+                init += values[i];
+                return false;
+            });
+
+        return init;
+    }
+
     // Sorting
     template <typename Compare>
     void sort_impl(size_t start_idx, size_t end_idx, Compare& comp) {
+        // A single element is already sorted, and must not be moved out below
+        if (pool->next_indices[start_idx] == end_idx) return;
+
+        [[maybe_unused]] auto region = pool->instrumentation().sort_region();
+
         // Collect values and indices for the range
         std::vector<std::pair<T, size_t>> values_with_indices;
         values_with_indices.reserve(size_);
         
-        for (size_t curr = start_idx; curr != end_idx; curr = next_indices[curr]) {
-            values_with_indices.emplace_back(std::move(data[curr]), curr);
+        for (size_t curr = start_idx; curr != end_idx; curr = pool->next_indices[curr]) {
+            values_with_indices.emplace_back(std::move(pool->data[curr]), curr);
         }
         
-        if (values_with_indices.size() <= 1) return;
-        
         // Sort by value using std::sort
         std::sort(values_with_indices.begin(), values_with_indices.end(),
                 [&comp](const auto& a, const auto& b) {
@@ -646,9 +1173,9 @@ public:
         
         // Restore values to original nodes in sorted order
         size_t i = 0;
-        for (size_t curr = start_idx; curr != end_idx; curr = next_indices[curr]) {
+        for (size_t curr = start_idx; curr != end_idx; curr = pool->next_indices[curr]) {
             auto& [value, original_idx] = values_with_indices[i++];
-            data[curr] = std::move(value);
+            pool->data[curr] = std::move(value);
         }
     }
 
@@ -669,4 +1196,9 @@ public:
     }
 };
 
+template <typename T, typename Allocator, typename Instrumentation, typename Predicate>
+size_t erase_if(FreeList<T, Allocator, Instrumentation>& list, Predicate pred) {
+    return list.remove_if(pred);
+}
+
 #endif
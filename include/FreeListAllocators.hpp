@@ -0,0 +1,211 @@
+#ifndef FREELISTALLOCATORS_HPP
+#define FREELISTALLOCATORS_HPP
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// Bump allocation out of large blocks, for lists that are built up and then
+// dropped as a whole. Freed memory is only reclaimed when it is the most
+// recent allocation; everything else is returned when the arena is released
+// or destroyed. A growing pool leaves its old arrays behind, which adds up
+// to at most the size of the final arrays.
+class FreeListArena {
+public:
+    explicit FreeListArena(size_t blockSize = size_t(1) << 20)
+        : blocks_(nullptr), cursor_(nullptr), end_(nullptr), last_(nullptr),
+          blockSize_(blockSize), reserved_(0) {}
+
+    FreeListArena(const FreeListArena&) = delete;
+    FreeListArena& operator=(const FreeListArena&) = delete;
+
+    ~FreeListArena() {
+        release();
+    }
+
+    void* allocate(size_t bytes, size_t alignment) {
+        char* p = (cursor_ != nullptr) ? alignUp(cursor_, alignment) : nullptr;
+        if (p == nullptr || bytes > size_t(end_ - p)) {
+            addBlock(bytes + alignment);
+            p = alignUp(cursor_, alignment);
+        }
+
+        cursor_ = p + bytes;
+        last_ = p;
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (p == last_ && static_cast<char*>(p) + bytes == cursor_) {
+            cursor_ = last_;
+            last_ = nullptr;
+        }
+    }
+
+    // Frees every block; memory handed out so far must no longer be in use
+    void release() noexcept {
+        while (blocks_ != nullptr) {
+            Block* previous = blocks_->previous;
+            ::operator delete(blocks_);
+            blocks_ = previous;
+        }
+        cursor_ = end_ = last_ = nullptr;
+        reserved_ = 0;
+    }
+
+    // Bytes taken from the system so far
+    size_t reserved() const noexcept { return reserved_; }
+
+private:
+    struct Block {
+        Block* previous;
+        size_t size;
+    };
+
+    static char* alignUp(char* p, size_t alignment) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - address % alignment) % alignment);
+    }
+
+    void addBlock(size_t minimum) {
+        size_t size = std::max(blockSize_, minimum + sizeof(Block));
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->previous = blocks_;
+        block->size = size;
+
+        blocks_ = block;
+        cursor_ = reinterpret_cast<char*>(block + 1);
+        end_ = reinterpret_cast<char*>(block) + size;
+        reserved_ += size;
+    }
+
+    Block* blocks_;
+    char* cursor_;
+    char* end_;
+    char* last_;
+    size_t blockSize_;
+    size_t reserved_;
+};
+
+// Standard allocator drawing from a FreeListArena, which must outlive
+// every container using it
+template <typename T>
+class FreeListArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit FreeListArenaAllocator(FreeListArena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    FreeListArenaAllocator(const FreeListArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t count) noexcept {
+        arena_->deallocate(p, count * sizeof(T));
+    }
+
+    FreeListArena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const FreeListArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const FreeListArenaAllocator<U>& other) const noexcept {
+        return arena_ != other.arena();
+    }
+
+private:
+    FreeListArena* arena_;
+};
+
+// Anonymous mappings advised for transparent huge pages, so large arrays
+// need far fewer TLB entries (whether huge pages are actually used is up
+// to the kernel's THP setting). reallocate() resizes a mapping with mremap,
+// moving page table entries instead of copying the contents, which lets a
+// FreeListPool over a trivially copyable type grow without copying.
+template <typename T>
+class FreeListHugePageAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t hugePageSize = size_t(2) << 20;
+
+    FreeListHugePageAllocator() noexcept = default;
+
+    template <typename U>
+    FreeListHugePageAllocator(const FreeListHugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        size_t bytes = mappedBytes(count);
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        advise(p, bytes);
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t count) noexcept {
+        ::munmap(p, mappedBytes(count));
+    }
+
+    // The contents are kept up to the smaller of the two sizes; the mapping
+    // may move, so p is invalid afterwards
+    T* reallocate(T* p, size_t oldCount, size_t newCount) {
+        size_t oldBytes = mappedBytes(oldCount);
+        size_t newBytes = mappedBytes(newCount);
+        if (oldBytes == newBytes) return p;
+
+        void* q = ::mremap(p, oldBytes, newBytes, MREMAP_MAYMOVE);
+        if (q == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        if (newBytes > oldBytes) {
+            advise(q, newBytes);
+        }
+        return static_cast<T*>(q);
+    }
+
+    template <typename U>
+    bool operator==(const FreeListHugePageAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const FreeListHugePageAllocator<U>&) const noexcept { return false; }
+
+private:
+    // Small arrays are rounded to whole pages, large ones to whole huge pages
+    static size_t mappedBytes(size_t count) {
+        if (count > (SIZE_MAX - hugePageSize) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+
+        static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t bytes = std::max<size_t>(count * sizeof(T), 1);
+        size_t granule = (bytes >= hugePageSize) ? hugePageSize : pageSize;
+        return (bytes + granule - 1) / granule * granule;
+    }
+
+    static void advise(void* p, size_t bytes) {
+        if (bytes >= hugePageSize) {
+            ::madvise(p, bytes, MADV_HUGEPAGE);
+        }
+    }
+};
+
+#endif
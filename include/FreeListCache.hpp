@@ -0,0 +1,228 @@
+#ifndef FREELISTCACHE_HPP
+#define FREELISTCACHE_HPP
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "FreeList.hpp"
+
+enum class FreeListEviction {
+    lru,    // Hits move the entry to the front, the back is evicted
+    clock   // Hits set a reference bit, a hand sweeping the list evicts
+};
+
+// Fixed-capacity key/value cache. Entries live in a FreeList in recency
+// order (clock order for FreeListEviction::clock) and an open-addressing
+// table maps keys to their FreeList slot index. A hit only relinks or
+// marks the entry, and once the cache is full a miss overwrites the
+// evicted entry in place, so steady-state operation never allocates.
+template <typename Key, typename Value,
+          FreeListEviction Policy = FreeListEviction::lru,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FreeListCache {
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        bool referenced;
+
+        template <typename K, typename V>
+        Entry(K&& k, V&& v) : key(std::forward<K>(k)), value(std::forward<V>(v)), referenced(false) {}
+    };
+
+    using List = FreeList<Entry>;
+
+    // One table slot: the entry's FreeList index and the top bits of its
+    // mixed hash, which also give the slot it wants to be in
+    struct Bucket {
+        uint32_t index;
+        uint32_t tag;
+    };
+
+    static constexpr uint32_t emptyBucket = UINT32_MAX;
+
+    List entries;
+    std::vector<Bucket> buckets;
+    unsigned bucketBits;
+    size_t capacity_;
+    typename List::iterator hand;  // Next clock candidate, end() before the first sweep
+
+    Hash hasher;
+    KeyEqual keyEqual;
+
+    // Helper methods
+    uint32_t tagOf(const Key& key) const {
+        uint64_t mixed = uint64_t(hasher(key)) * 0x9E3779B97F4A7C15ull;
+        return uint32_t(mixed >> 32);
+    }
+
+    size_t home(uint32_t tag) const {
+        return tag >> (32 - bucketBits);
+    }
+
+    size_t mask() const {
+        return buckets.size() - 1;
+    }
+
+    typename List::iterator at(uint32_t index) {
+        return typename List::iterator(&entries, index);
+    }
+
+    // Returns the bucket holding key, or the empty bucket where it would go
+    size_t probe(const Key& key, uint32_t tag) const {
+        size_t pos = home(tag);
+        while (buckets[pos].index != emptyBucket) {
+            const Bucket& bucket = buckets[pos];
+            if (bucket.tag == tag &&
+                keyEqual(typename List::const_iterator(&entries, bucket.index)->key, key)) {
+                break;
+            }
+            pos = (pos + 1) & mask();
+        }
+        return pos;
+    }
+
+    // Backward-shift deletion: later buckets of the same probe run move up
+    // into the hole, so lookups never need tombstones
+    void removeBucket(size_t hole) {
+        for (size_t next = (hole + 1) & mask(); buckets[next].index != emptyBucket; next = (next + 1) & mask()) {
+            size_t wanted = home(buckets[next].tag);
+            if (((next - wanted) & mask()) >= ((next - hole) & mask())) {
+                buckets[hole] = buckets[next];
+                hole = next;
+            }
+        }
+        buckets[hole].index = emptyBucket;
+    }
+
+    void touch(typename List::iterator it) {
+        if constexpr (Policy == FreeListEviction::lru) {
+            entries.splice(entries.begin(), entries, it);
+        } else {
+            it->referenced = true;
+        }
+    }
+
+    // Picks the entry to overwrite; for clock also moves the hand past it
+    typename List::iterator victim() {
+        if constexpr (Policy == FreeListEviction::lru) {
+            return std::prev(entries.end());
+        } else {
+            for (;;) {
+                if (hand == entries.end()) {
+                    --hand;
+                }
+                typename List::iterator candidate = hand--;
+                if (!candidate->referenced) {
+                    return candidate;
+                }
+                candidate->referenced = false;
+            }
+        }
+    }
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+
+    explicit FreeListCache(size_t capacity, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : bucketBits(3), capacity_(capacity), hasher(hash), keyEqual(equal) {
+        if (capacity == 0 || capacity >= emptyBucket / 2) {
+            throw std::length_error("FreeListCache capacity out of range");
+        }
+
+        // Keep the table at most half full
+        while ((size_t(1) << bucketBits) < capacity * 2) {
+            bucketBits++;
+        }
+        buckets.assign(size_t(1) << bucketBits, Bucket{emptyBucket, 0});
+
+        entries.reserve(capacity);
+        hand = entries.end();
+    }
+
+    // The cache hands out pointers into its list and keeps an iterator to it
+    FreeListCache(const FreeListCache&) = delete;
+    FreeListCache& operator=(const FreeListCache&) = delete;
+
+    size_t size() const noexcept { return entries.size(); }
+    size_t capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return entries.empty(); }
+
+    // Looks a key up without counting it as a use
+    bool contains(const Key& key) const {
+        return buckets[probe(key, tagOf(key))].index != emptyBucket;
+    }
+
+    // Returns the cached value and counts the use, or nullptr on a miss.
+    // The pointer stays valid until the entry is evicted or erased.
+    Value* get(const Key& key) {
+        size_t pos = probe(key, tagOf(key));
+        if (buckets[pos].index == emptyBucket) return nullptr;
+
+        typename List::iterator it = at(buckets[pos].index);
+        touch(it);
+        return &it->value;
+    }
+
+    // Inserts or replaces the value for key, evicting when full
+    template <typename K, typename V>
+    Value& put(K&& key, V&& value) {
+        uint32_t tag = tagOf(key);
+        size_t pos = probe(key, tag);
+
+        if (buckets[pos].index != emptyBucket) {
+            typename List::iterator it = at(buckets[pos].index);
+            it->value = std::forward<V>(value);
+            touch(it);
+            return it->value;
+        }
+
+        typename List::iterator it;
+        if (entries.size() < capacity_) {
+            it = entries.emplace(entries.begin(), std::forward<K>(key), std::forward<V>(value));
+        } else {
+            // Reuse the victim's slot: drop its key from the table and
+            // overwrite the entry where it is
+            it = victim();
+            removeBucket(probe(it->key, tagOf(it->key)));
+            pos = probe(key, tag);
+
+            it->key = std::forward<K>(key);
+            it->value = std::forward<V>(value);
+            it->referenced = false;
+            if constexpr (Policy == FreeListEviction::lru) {
+                entries.splice(entries.begin(), entries, it);
+            }
+        }
+
+        buckets[pos] = Bucket{entries.handle(it).index, tag};
+        return it->value;
+    }
+
+    bool erase(const Key& key) {
+        size_t pos = probe(key, tagOf(key));
+        if (buckets[pos].index == emptyBucket) return false;
+
+        typename List::iterator it = at(buckets[pos].index);
+        if (it == hand) {
+            --hand;
+        }
+        removeBucket(pos);
+        entries.erase(it);
+        return true;
+    }
+
+    void clear() {
+        entries.clear();
+        buckets.assign(buckets.size(), Bucket{emptyBucket, 0});
+        hand = entries.end();
+    }
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef FREELISTINSTRUMENTATION_HPP
+#define FREELISTINSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstddef>
+
+// Instrumentation policies for FreeListPool and FreeList, selected by the
+// last template parameter. The pool inherits from its policy, so an empty
+// policy adds no storage, and every hook is called unconditionally, so
+// empty inline hooks compile away.
+//
+// A policy provides:
+//
+//   on_free_chain_allocation(n)  n nodes taken from the free chain
+//   on_fresh_allocation(n)       n nodes taken from never-used slots
+//   on_reallocation(bytes)       the arrays moved to new storage, copying
+//                                bytes (0 when the allocator remapped them)
+//   on_find(visited)             a find() call that visited that many nodes
+//   growth_region()              scope object alive while storage is moved
+//   sort_region()                scope object alive during a sort
+//
+// Counters are kept per pool, so lists sharing a pool share them.
+
+// The default: every hook is empty
+struct FreeListNoInstrumentation {
+    struct Region {};
+
+    void on_free_chain_allocation(size_t) noexcept {}
+    void on_fresh_allocation(size_t) noexcept {}
+    void on_reallocation(size_t) noexcept {}
+    void on_find(size_t) noexcept {}
+
+    Region growth_region() noexcept { return Region{}; }
+    Region sort_region() noexcept { return Region{}; }
+};
+
+struct FreeListCounters {
+    size_t free_chain_allocations = 0;
+    size_t fresh_allocations = 0;
+    size_t reallocations = 0;
+    size_t bytes_copied = 0;
+    size_t finds = 0;
+    size_t find_nodes_visited = 0;
+    size_t sorts = 0;
+    std::chrono::nanoseconds sort_time{0};
+};
+
+// Counts operations and times sorts
+class FreeListInstrumentation {
+public:
+    // Adds the time from construction to destruction to sort_time
+    class SortTimer {
+    public:
+        explicit SortTimer(FreeListCounters& counters)
+            : counters(counters), start(std::chrono::steady_clock::now()) {}
+
+        SortTimer(const SortTimer&) = delete;
+        SortTimer& operator=(const SortTimer&) = delete;
+
+        ~SortTimer() {
+            counters.sort_time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start);
+            counters.sorts++;
+        }
+
+    private:
+        FreeListCounters& counters;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void on_free_chain_allocation(size_t count) noexcept {
+        counters_.free_chain_allocations += count;
+    }
+
+    void on_fresh_allocation(size_t count) noexcept {
+        counters_.fresh_allocations += count;
+    }
+
+    void on_reallocation(size_t bytesCopied) noexcept {
+        counters_.reallocations++;
+        counters_.bytes_copied += bytesCopied;
+    }
+
+    void on_find(size_t visited) noexcept {
+        counters_.finds++;
+        counters_.find_nodes_visited += visited;
+    }
+
+    FreeListNoInstrumentation::Region growth_region() noexcept {
+        return FreeListNoInstrumentation::Region{};
+    }
+
+    SortTimer sort_region() {
+        return SortTimer(counters_);
+    }
+
+    const FreeListCounters& counters() const noexcept { return counters_; }
+
+    void reset_counters() noexcept {
+        counters_ = FreeListCounters();
+    }
+
+protected:
+    FreeListCounters counters_;
+};
+
+#endif
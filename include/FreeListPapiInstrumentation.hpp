@@ -0,0 +1,102 @@
+#ifndef FREELISTPAPIINSTRUMENTATION_HPP
+#define FREELISTPAPIINSTRUMENTATION_HPP
+
+#include <papiCPP.hpp>
+#include <array>
+#include <stdexcept>
+#include <utility>
+#include <cstddef>
+
+#include "FreeListInstrumentation.hpp"
+
+// FreeListInstrumentation that also counts the given PAPI events while
+// storage grows and while sort runs, accumulating each region separately.
+// PAPI runs one event set per thread at a time; a region that starts while
+// another event_set is counting records nothing for that region.
+template <papi::event_code... Events>
+class FreeListPapiInstrumentation : public FreeListInstrumentation {
+public:
+    using totals_type = std::array<papi::papi_counter, sizeof...(Events)>;
+
+    // Counts events for as long as it is alive and adds them to totals.
+    // If counting cannot start, e.g. because another event set is running,
+    // the region counts nothing rather than failing the list operation.
+    class Region {
+    public:
+        Region(papi::event_set<Events...>& events, totals_type& totals)
+            : events(events), totals(totals), active(false) {
+            try {
+                events.start_counters();
+                active = true;
+            } catch (const std::runtime_error&) {
+            }
+        }
+
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+
+        ~Region() {
+            if (!active) return;
+
+            try {
+                events.stop_counters();
+                accumulate(std::make_index_sequence<sizeof...(Events)>());
+                events.reset_counters();
+            } catch (const std::runtime_error&) {
+                // Counts of a region that failed to stop are dropped
+            }
+        }
+
+    private:
+        template <size_t... I>
+        void accumulate(std::index_sequence<I...>) {
+            ((totals[I] += events.template at<I>().counter()), ...);
+        }
+
+        papi::event_set<Events...>& events;
+        totals_type& totals;
+        bool active;
+    };
+
+    // Sorts are timed as well as counted
+    class SortRegion {
+    public:
+        SortRegion(FreeListCounters& counters, papi::event_set<Events...>& events, totals_type& totals)
+            : timer(counters), region(events, totals) {}
+
+    private:
+        SortTimer timer;
+        Region region;
+    };
+
+    FreeListPapiInstrumentation() : growthTotals_{}, sortTotals_{} {}
+
+    // An event set belongs to one pool
+    FreeListPapiInstrumentation(const FreeListPapiInstrumentation&) = delete;
+    FreeListPapiInstrumentation& operator=(const FreeListPapiInstrumentation&) = delete;
+
+    Region growth_region() {
+        return Region(events_, growthTotals_);
+    }
+
+    SortRegion sort_region() {
+        return SortRegion(counters_, events_, sortTotals_);
+    }
+
+    // Event totals in the order of Events
+    const totals_type& growth_events() const noexcept { return growthTotals_; }
+    const totals_type& sort_events() const noexcept { return sortTotals_; }
+
+    void reset_counters() noexcept {
+        FreeListInstrumentation::reset_counters();
+        growthTotals_.fill(0);
+        sortTotals_.fill(0);
+    }
+
+private:
+    papi::event_set<Events...> events_;
+    totals_type growthTotals_;
+    totals_type sortTotals_;
+};
+
+#endif
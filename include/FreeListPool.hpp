@@ -0,0 +1,734 @@
+#ifndef FREELISTPOOL_HPP
+#define FREELISTPOOL_HPP
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "FreeListSnapshot.hpp"
+#include "FreeListInstrumentation.hpp"
+
+template<typename T, typename Allocator = std::allocator<T>, typename Instrumentation = FreeListNoInstrumentation>
+class FreeList;
+
+// Names one element of a FreeList: its slot index and the generation the
+// slot had when the handle was issued. Packs into 64 bits for use as an ID.
+struct FreeListHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    uint64_t value() const {
+        return (uint64_t(generation) << 32) | index;
+    }
+
+    static FreeListHandle from_value(uint64_t value) {
+        return FreeListHandle{uint32_t(value), uint32_t(value >> 32)};
+    }
+
+    bool operator==(const FreeListHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const FreeListHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+// Node storage for one or more FreeLists. The pool owns the SoA arrays and
+// the chain of free slots; each list only links its own nodes, so lists that
+// share a pool can exchange nodes by relinking indices.
+//
+// Every array comes from Allocator, rebound to the array's element type. An
+// allocator that also provides reallocate(p, oldCount, newCount), moving the
+// contents without copying them, lets the pool grow in place when T is
+// trivially copyable.
+//
+// Instrumentation is a policy from FreeListInstrumentation.hpp whose hooks
+// the pool and its lists call on allocation, growth, find and sort.
+template<typename T, typename Allocator = std::allocator<T>, typename Instrumentation = FreeListNoInstrumentation>
+class FreeListPool : private Instrumentation {
+    friend class FreeList<T, Allocator, Instrumentation>;
+
+private:
+    // Structure of Arrays (SoA) approach, all arrays share one capacity
+    size_t* next_indices;  // Linked list "next" pointers
+    size_t* prev_indices;  // Linked list "prev" pointers
+    size_t* next_free;     // Free list management
+    T* data;               // Uninitialized storage, a slot holds a T only while linked
+    uint64_t* live_bits;   // One bit per slot, set while the slot holds a T
+    uint32_t* generations; // Bumped every time a slot is freed
+
+    size_t freeHead;
+    size_t slots_;     // Slots handed out so far (live or on the free chain)
+    size_t capacity_;  // Slots available in every array
+    size_t live_;      // Linked nodes across all lists
+    size_t genLimit_;  // Slots whose generation has been initialized
+    uint32_t epoch_;   // Generation given to never-used slots
+
+    void* mapping_;        // Snapshot the arrays live in, if any
+    size_t mappingLength_;
+
+    Allocator allocator_;
+
+    // Storage helpers
+    template <typename U>
+    using ArrayAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+    template <typename A, typename U, typename = void>
+    struct HasReallocate : std::false_type {};
+
+    template <typename A, typename U>
+    struct HasReallocate<A, U, std::void_t<decltype(
+        std::declval<A&>().reallocate(std::declval<U*>(), size_t(), size_t()))>> : std::true_type {};
+
+    static constexpr bool growsInPlace =
+        std::is_trivially_copyable<T>::value && HasReallocate<ArrayAllocator<T>, T>::value;
+
+    template <typename U>
+    U* allocateArray(size_t count) {
+        ArrayAllocator<U> alloc(allocator_);
+        return std::allocator_traits<ArrayAllocator<U>>::allocate(alloc, count);
+    }
+
+    template <typename U>
+    void deallocateArray(U* array, size_t count) {
+        if (array != nullptr) {
+            ArrayAllocator<U> alloc(allocator_);
+            std::allocator_traits<ArrayAllocator<U>>::deallocate(alloc, array, count);
+        }
+    }
+
+    template <typename U>
+    U* reallocateArray(U* array, size_t oldCount, size_t newCount) {
+        ArrayAllocator<U> alloc(allocator_);
+        return alloc.reallocate(array, oldCount, newCount);
+    }
+
+    size_t growthCapacity() const {
+        return capacity_ < 8 ? 16 : capacity_ * 2;
+    }
+
+    static size_t bitWords(size_t count) {
+        return (count + 63) / 64;
+    }
+
+    bool isLive(size_t index) const {
+        return (live_bits[index / 64] >> (index % 64)) & 1;
+    }
+
+    void markLive(size_t index) {
+        live_bits[index / 64] |= uint64_t(1) << (index % 64);
+    }
+
+    void markFree(size_t index) {
+        live_bits[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+
+    void markLiveRange(size_t first, size_t last) {
+        for (; first < last && first % 64 != 0; ++first) {
+            markLive(first);
+        }
+        for (; first + 64 <= last; first += 64) {
+            live_bits[first / 64] = ~uint64_t(0);
+        }
+        for (; first < last; ++first) {
+            markLive(first);
+        }
+    }
+
+    // Visits live slots in index order. Words with every bit set go to
+    // block(first, last) as a dense run the caller can write as a plain
+    // loop; the remaining live slots go to one(index) individually.
+    // Either callback returns true to stop the scan early.
+    template <typename Block, typename One>
+    void scanLive(Block block, One one) const {
+        size_t words = bitWords(slots_);
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t bits = live_bits[w];
+            size_t base = w * 64;
+
+            if (bits == ~uint64_t(0)) {
+                if (block(base, base + 64)) return;
+                continue;
+            }
+
+            while (bits != 0) {
+                if (one(base + __builtin_ctzll(bits))) return;
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    void destroyLive() {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            scanLive(
+                [this](size_t first, size_t last) {
+                    std::destroy(data + first, data + last);
+                    return false;
+                },
+                [this](size_t i) {
+                    std::destroy_at(data + i);
+                    return false;
+                });
+        }
+    }
+
+    void releaseStorage() {
+        destroyLive();
+        if (mapping_ != nullptr) {
+            FreeListSnapshot::unmap(mapping_, mappingLength_);
+            mapping_ = nullptr;
+            mappingLength_ = 0;
+            return;
+        }
+        deallocateArray(next_indices, capacity_);
+        deallocateArray(prev_indices, capacity_);
+        deallocateArray(next_free, capacity_);
+        deallocateArray(data, capacity_);
+        deallocateArray(live_bits, bitWords(capacity_));
+        deallocateArray(generations, capacity_);
+    }
+
+    // Forgets the generations of slots at and above limit. Slots initialized
+    // later start past every generation dropped here, so stale handles into
+    // them keep failing.
+    void dropGenerations(size_t limit) {
+        for (size_t i = limit; i < genLimit_; ++i) {
+            epoch_ = std::max(epoch_, generations[i]);
+        }
+        genLimit_ = std::min(genLimit_, limit);
+    }
+
+    // Moves every live element into newData (already sized to newCapacity)
+    // and swaps in freshly allocated index arrays. On failure newData is
+    // left to the caller and the current storage is untouched.
+    void adoptStorage(T* newData, size_t newCapacity) {
+        [[maybe_unused]] auto region = instrumentation().growth_region();
+
+        size_t* newNext = nullptr;
+        size_t* newPrev = nullptr;
+        size_t* newFree = nullptr;
+        uint64_t* newBits = nullptr;
+        uint32_t* newGens = nullptr;
+
+        try {
+            newNext = allocateArray<size_t>(newCapacity);
+            newPrev = allocateArray<size_t>(newCapacity);
+            newFree = allocateArray<size_t>(newCapacity);
+            newBits = allocateArray<uint64_t>(bitWords(newCapacity));
+            newGens = allocateArray<uint32_t>(newCapacity);
+        } catch (...) {
+            deallocateArray(newNext, newCapacity);
+            deallocateArray(newPrev, newCapacity);
+            deallocateArray(newFree, newCapacity);
+            deallocateArray(newBits, bitWords(newCapacity));
+            throw;
+        }
+
+        if (genLimit_ != 0) {
+            std::memcpy(newGens, generations, genLimit_ * sizeof(uint32_t));
+        }
+
+        if (slots_ != 0) {
+            std::memcpy(newNext, next_indices, slots_ * sizeof(size_t));
+            std::memcpy(newPrev, prev_indices, slots_ * sizeof(size_t));
+            std::memcpy(newFree, next_free, slots_ * sizeof(size_t));
+            std::memcpy(newBits, live_bits, bitWords(slots_) * sizeof(uint64_t));
+        }
+        std::memset(newBits + bitWords(slots_), 0,
+                    (bitWords(newCapacity) - bitWords(slots_)) * sizeof(uint64_t));
+
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (slots_ != 0) {
+                std::memcpy(static_cast<void*>(newData), data, slots_ * sizeof(T));
+            }
+        } else {
+            size_t i = 0;
+            try {
+                for (; i < slots_; ++i) {
+                    if (isLive(i)) {
+                        ::new (static_cast<void*>(newData + i)) T(std::move_if_noexcept(data[i]));
+                    }
+                }
+            } catch (...) {
+                for (size_t done = 0; done < i; ++done) {
+                    if (isLive(done)) {
+                        std::destroy_at(newData + done);
+                    }
+                }
+                deallocateArray(newNext, newCapacity);
+                deallocateArray(newPrev, newCapacity);
+                deallocateArray(newFree, newCapacity);
+                deallocateArray(newBits, bitWords(newCapacity));
+                deallocateArray(newGens, newCapacity);
+                throw;
+            }
+        }
+
+        releaseStorage();
+        instrumentation().on_reallocation(
+            slots_ * (3 * sizeof(size_t) + sizeof(T)) +
+            bitWords(slots_) * sizeof(uint64_t) + genLimit_ * sizeof(uint32_t));
+
+        next_indices = newNext;
+        prev_indices = newPrev;
+        next_free = newFree;
+        data = newData;
+        live_bits = newBits;
+        generations = newGens;
+        capacity_ = newCapacity;
+    }
+
+    // Resizes one array in place through the allocator, arrays numbered in
+    // declaration order
+    void remapArray(int which, size_t from, size_t to) {
+        switch (which) {
+        case 0: next_indices = reallocateArray(next_indices, from, to); break;
+        case 1: prev_indices = reallocateArray(prev_indices, from, to); break;
+        case 2: next_free = reallocateArray(next_free, from, to); break;
+        case 3: data = reallocateArray(data, from, to); break;
+        case 4: live_bits = reallocateArray(live_bits, bitWords(from), bitWords(to)); break;
+        case 5: generations = reallocateArray(generations, from, to); break;
+        }
+    }
+
+    // Only for allocated storage: a mapped snapshot or an empty pool takes
+    // the copying path
+    bool canRemap() const {
+        return growsInPlace && mapping_ == nullptr && capacity_ != 0;
+    }
+
+    // Resizes every array without copying the elements. If one array fails
+    // the ones already resized are put back, leaving the pool unchanged.
+    void remapStorage(size_t newCapacity) {
+        [[maybe_unused]] auto region = instrumentation().growth_region();
+
+        int done = 0;
+        try {
+            for (; done < 6; ++done) {
+                remapArray(done, capacity_, newCapacity);
+            }
+        } catch (...) {
+            while (done-- > 0) {
+                remapArray(done, newCapacity, capacity_);
+            }
+            throw;
+        }
+
+        if (bitWords(newCapacity) > bitWords(capacity_)) {
+            std::memset(live_bits + bitWords(capacity_), 0,
+                        (bitWords(newCapacity) - bitWords(capacity_)) * sizeof(uint64_t));
+        }
+        capacity_ = newCapacity;
+        instrumentation().on_reallocation(0);
+    }
+
+    // The new element is built in the new storage before the old one is
+    // released, so args may refer to elements already in the pool.
+    template <typename... Args>
+    void growAndConstruct(size_t index, Args&&... args) {
+        if constexpr (growsInPlace) {
+            if (canRemap()) {
+                // Remapping invalidates args that point into the pool
+                T value(std::forward<Args>(args)...);
+                remapStorage(growthCapacity());
+                ::new (static_cast<void*>(data + index)) T(value);
+                return;
+            }
+        }
+
+        size_t newCapacity = growthCapacity();
+        T* newData = allocateArray<T>(newCapacity);
+
+        try {
+            ::new (static_cast<void*>(newData + index)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocateArray(newData, newCapacity);
+            throw;
+        }
+
+        try {
+            adoptStorage(newData, newCapacity);
+        } catch (...) {
+            std::destroy_at(newData + index);
+            deallocateArray(newData, newCapacity);
+            throw;
+        }
+    }
+
+    // Returns an unlinked node holding a newly constructed T
+    template <typename... Args>
+    size_t allocateNode(Args&&... args) {
+        size_t index;
+
+        if (freeHead != SIZE_MAX) {
+            // Reuse a freed node
+            index = freeHead;
+            ::new (static_cast<void*>(data + index)) T(std::forward<Args>(args)...);
+            freeHead = next_free[index];
+            instrumentation().on_free_chain_allocation(1);
+        } else if (slots_ < capacity_) {
+            // Take the next untouched slot
+            index = slots_;
+            ::new (static_cast<void*>(data + index)) T(std::forward<Args>(args)...);
+            slots_++;
+            instrumentation().on_fresh_allocation(1);
+        } else {
+            // Grow all arrays together
+            index = slots_;
+            growAndConstruct(index, std::forward<Args>(args)...);
+            slots_++;
+            instrumentation().on_fresh_allocation(1);
+        }
+
+        if (index >= genLimit_) {
+            generations[index] = epoch_;
+            genLimit_ = index + 1;
+        }
+
+        next_indices[index] = SIZE_MAX;
+        prev_indices[index] = SIZE_MAX;
+        next_free[index] = SIZE_MAX;
+        markLive(index);
+
+        live_++;
+        return index;
+    }
+
+    // Builds count nodes linked to each other in order, make(slot) placement-
+    // constructing each element. Freed slots are reused first and the rest
+    // come from one contiguous block, so the arrays grow at most once and
+    // the block's links are written in a single sequential pass.
+    // Returns the first and last node of the detached chain.
+    template <typename Make>
+    std::pair<size_t, size_t> allocateRun(size_t count, Make make) {
+        size_t first = SIZE_MAX;
+        size_t last = SIZE_MAX;
+        size_t done = 0;
+
+        try {
+            // Reuse freed nodes
+            while (done < count && freeHead != SIZE_MAX) {
+                size_t index = freeHead;
+                make(data + index);
+                freeHead = next_free[index];
+
+                next_free[index] = SIZE_MAX;
+                next_indices[index] = SIZE_MAX;
+                prev_indices[index] = last;
+                markLive(index);
+
+                if (last == SIZE_MAX) {
+                    first = index;
+                } else {
+                    next_indices[last] = index;
+                }
+                last = index;
+
+                done++;
+                live_++;
+            }
+            instrumentation().on_free_chain_allocation(done);
+
+            if (done < count) {
+                size_t remaining = count - done;
+                if (slots_ + remaining > capacity_) {
+                    reserve(std::max(slots_ + remaining, growthCapacity()));
+                }
+
+                size_t start = slots_;
+                size_t end = start + remaining;
+                size_t built = start;
+                try {
+                    for (; built < end; ++built) {
+                        make(data + built);
+                    }
+                } catch (...) {
+                    std::destroy(data + start, data + built);
+                    throw;
+                }
+
+                for (size_t i = start; i < end; ++i) {
+                    next_indices[i] = i + 1;
+                    prev_indices[i] = i - 1;
+                    next_free[i] = SIZE_MAX;
+                }
+                markLiveRange(start, end);
+
+                for (size_t i = std::max(start, genLimit_); i < end; ++i) {
+                    generations[i] = epoch_;
+                }
+                genLimit_ = std::max(genLimit_, end);
+
+                prev_indices[start] = last;
+                next_indices[end - 1] = SIZE_MAX;
+                if (last == SIZE_MAX) {
+                    first = start;
+                } else {
+                    next_indices[last] = start;
+                }
+                last = end - 1;
+
+                slots_ = end;
+                live_ += remaining;
+                instrumentation().on_fresh_allocation(remaining);
+            }
+        } catch (...) {
+            if (first != SIZE_MAX) {
+                releaseChain(first, last);
+            }
+            throw;
+        }
+
+        return {first, last};
+    }
+
+    // Destroys the element of an already unlinked node and frees its slot
+    void releaseNode(size_t index) {
+        std::destroy_at(data + index);
+        markFree(index);
+        generations[index]++;
+        next_free[index] = freeHead;
+        freeHead = index;
+        live_--;
+    }
+
+    // Frees the detached chain first..last (inclusive) in one pass, reusing
+    // the chain's own links as the free chain. Returns the number of nodes.
+    size_t releaseChain(size_t first, size_t last) {
+        size_t count = 0;
+        for (size_t curr = first;; curr = next_indices[curr]) {
+            std::destroy_at(data + curr);
+            markFree(curr);
+            generations[curr]++;
+            count++;
+
+            if (curr == last) {
+                next_free[curr] = freeHead;
+                break;
+            }
+            next_free[curr] = next_indices[curr];
+        }
+
+        freeHead = first;
+        live_ -= count;
+        return count;
+    }
+
+    // Drops every node while keeping the allocated capacity
+    void reset() {
+        scanLive(
+            [this](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    generations[i]++;
+                }
+                return false;
+            },
+            [this](size_t i) {
+                generations[i]++;
+                return false;
+            });
+        destroyLive();
+        if (slots_ != 0) {
+            std::memset(live_bits, 0, bitWords(slots_) * sizeof(uint64_t));
+        }
+        freeHead = SIZE_MAX;
+        slots_ = 0;
+        live_ = 0;
+    }
+
+    // Writes every slot along with the state of one list, which must be the
+    // only list drawing from this pool
+    void saveSnapshot(const std::string& path, size_t head, size_t tail, size_t size) const {
+        static_assert(std::is_trivially_copyable<T>::value, "FreeList snapshots need a trivially copyable type");
+
+        // Generations above slots_ are not saved, fold them into the epoch
+        uint32_t epoch = epoch_;
+        for (size_t i = slots_; i < genLimit_; ++i) {
+            epoch = std::max(epoch, generations[i]);
+        }
+
+        FreeListSnapshot::Header header{};
+        header.valueSize = sizeof(T);
+        header.valueAlign = alignof(T);
+        header.slots = slots_;
+        header.live = live_;
+        header.freeHead = freeHead;
+        header.epoch = epoch;
+        header.head = head;
+        header.tail = tail;
+        header.size = size;
+
+        header.bytes[FreeListSnapshot::nextArray] = slots_ * sizeof(size_t);
+        header.bytes[FreeListSnapshot::prevArray] = slots_ * sizeof(size_t);
+        header.bytes[FreeListSnapshot::freeArray] = slots_ * sizeof(size_t);
+        header.bytes[FreeListSnapshot::dataArray] = slots_ * sizeof(T);
+        header.bytes[FreeListSnapshot::bitsArray] = bitWords(slots_) * sizeof(uint64_t);
+        header.bytes[FreeListSnapshot::generationsArray] = std::min(slots_, genLimit_) * sizeof(uint32_t);
+
+        const void* const arrays[FreeListSnapshot::arrayCount] = {
+            next_indices, prev_indices, next_free, data, live_bits, generations
+        };
+        FreeListSnapshot::write(path, header, arrays);
+    }
+
+    // Takes ownership of a mapped snapshot and uses its arrays in place. The
+    // first growth copies them out to allocated storage and unmaps the file.
+    void adoptMapping(const FreeListSnapshot::Mapping& mapping) {
+        static_assert(std::is_trivially_copyable<T>::value, "FreeList snapshots need a trivially copyable type");
+
+        const FreeListSnapshot::Header& header = *mapping.header;
+        next_indices = mapping.template array<size_t>(FreeListSnapshot::nextArray);
+        prev_indices = mapping.template array<size_t>(FreeListSnapshot::prevArray);
+        next_free = mapping.template array<size_t>(FreeListSnapshot::freeArray);
+        data = mapping.template array<T>(FreeListSnapshot::dataArray);
+        live_bits = mapping.template array<uint64_t>(FreeListSnapshot::bitsArray);
+        generations = mapping.template array<uint32_t>(FreeListSnapshot::generationsArray);
+
+        freeHead = header.freeHead;
+        slots_ = header.slots;
+        capacity_ = header.slots;
+        live_ = header.live;
+        genLimit_ = header.bytes[FreeListSnapshot::generationsArray] / sizeof(uint32_t);
+        epoch_ = static_cast<uint32_t>(header.epoch);
+
+        mapping_ = mapping.base;
+        mappingLength_ = mapping.length;
+    }
+
+    // Slot-for-slot copy, used when a list that owns its pool is copied
+    FreeListPool(const FreeListPool& other)
+        : FreeListPool(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator_)) {
+        if (other.slots_ == 0) return;
+
+        // The delegated constructor has completed, so the destructor
+        // releases whatever was allocated if a copy below throws
+        capacity_ = other.slots_;
+        next_indices = allocateArray<size_t>(capacity_);
+        prev_indices = allocateArray<size_t>(capacity_);
+        next_free = allocateArray<size_t>(capacity_);
+        data = allocateArray<T>(capacity_);
+        live_bits = allocateArray<uint64_t>(bitWords(capacity_));
+        generations = allocateArray<uint32_t>(capacity_);
+
+        std::memcpy(next_indices, other.next_indices, other.slots_ * sizeof(size_t));
+        std::memcpy(generations, other.generations, other.slots_ * sizeof(uint32_t));
+        genLimit_ = other.slots_;
+        epoch_ = other.epoch_;
+        std::memcpy(prev_indices, other.prev_indices, other.slots_ * sizeof(size_t));
+        std::memcpy(next_free, other.next_free, other.slots_ * sizeof(size_t));
+
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            std::memcpy(static_cast<void*>(data), other.data, other.slots_ * sizeof(T));
+            std::memcpy(live_bits, other.live_bits, bitWords(capacity_) * sizeof(uint64_t));
+        } else {
+            // Slots only count as live once their copy exists
+            std::memset(live_bits, 0, bitWords(capacity_) * sizeof(uint64_t));
+            slots_ = other.slots_;
+            other.scanLive(
+                [this, &other](size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) {
+                        ::new (static_cast<void*>(data + i)) T(other.data[i]);
+                        markLive(i);
+                    }
+                    return false;
+                },
+                [this, &other](size_t i) {
+                    ::new (static_cast<void*>(data + i)) T(other.data[i]);
+                    markLive(i);
+                    return false;
+                });
+        }
+
+        freeHead = other.freeHead;
+        slots_ = other.slots_;
+        live_ = other.live_;
+    }
+
+public:
+    FreeListPool() : FreeListPool(Allocator()) {}
+
+    explicit FreeListPool(const Allocator& alloc)
+        : next_indices(nullptr), prev_indices(nullptr), next_free(nullptr), data(nullptr),
+          live_bits(nullptr), generations(nullptr), freeHead(SIZE_MAX),
+          slots_(0), capacity_(0), live_(0), genLimit_(0), epoch_(0),
+          mapping_(nullptr), mappingLength_(0), allocator_(alloc) {}
+
+    explicit FreeListPool(size_t count, const Allocator& alloc = Allocator()) : FreeListPool(alloc) {
+        reserve(count);
+    }
+
+    // Lists refer to their pool by address
+    FreeListPool& operator=(const FreeListPool&) = delete;
+
+    ~FreeListPool() {
+        releaseStorage();
+    }
+
+    Allocator get_allocator() const { return allocator_; }
+
+    Instrumentation& instrumentation() noexcept { return *this; }
+    const Instrumentation& instrumentation() const noexcept { return *this; }
+
+    // Linked nodes across every list drawing from this pool
+    size_t size() const noexcept { return live_; }
+    size_t capacity() const noexcept { return capacity_; }
+
+    void reserve(size_t count) {
+        if (count <= capacity_) return;
+
+        if constexpr (growsInPlace) {
+            if (canRemap()) {
+                remapStorage(count);
+                return;
+            }
+        }
+
+        T* newData = allocateArray<T>(count);
+        try {
+            adoptStorage(newData, count);
+        } catch (...) {
+            deallocateArray(newData, count);
+            throw;
+        }
+    }
+
+    void shrink_to_fit() {
+        if (capacity_ == slots_) return;
+
+        dropGenerations(slots_);
+
+        if (slots_ == 0) {
+            releaseStorage();
+            next_indices = prev_indices = next_free = nullptr;
+            data = nullptr;
+            live_bits = nullptr;
+            generations = nullptr;
+            capacity_ = 0;
+            return;
+        }
+
+        if constexpr (growsInPlace) {
+            if (canRemap()) {
+                remapStorage(slots_);
+                return;
+            }
+        }
+
+        T* newData = allocateArray<T>(slots_);
+        try {
+            adoptStorage(newData, slots_);
+        } catch (...) {
+            deallocateArray(newData, slots_);
+            throw;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef FREELISTSNAPSHOT_HPP
+#define FREELISTSNAPSHOT_HPP
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+enum class FreeListMapMode {
+    read_only,      // Pages are shared with the file, the list must not be modified
+    copy_on_write   // Pages are copied on first write, the file is never changed
+};
+
+// On-disk image of a FreeList over a trivially copyable type: a fixed
+// header followed by the pool's arrays, each starting on its own page so
+// the file can be mapped and the arrays used in place.
+class FreeListSnapshot {
+public:
+    enum Array {
+        nextArray,
+        prevArray,
+        freeArray,
+        dataArray,
+        bitsArray,
+        generationsArray,
+        arrayCount
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t indexSize;    // sizeof(size_t) of the writer
+        uint64_t valueSize;
+        uint64_t valueAlign;
+
+        // Pool state
+        uint64_t slots;
+        uint64_t live;
+        uint64_t freeHead;
+        uint64_t epoch;
+
+        // List state
+        uint64_t head;
+        uint64_t tail;
+        uint64_t size;
+
+        uint64_t offsets[arrayCount];
+        uint64_t bytes[arrayCount];
+        uint64_t fileSize;
+    };
+
+    struct Mapping {
+        void* base;
+        size_t length;
+        const Header* header;
+
+        template <typename U>
+        U* array(Array which) const {
+            return reinterpret_cast<U*>(static_cast<char*>(base) + header->offsets[which]);
+        }
+    };
+
+    static constexpr uint32_t currentVersion = 1;
+    static constexpr uint64_t arrayAlign = 4096;
+
+    // Lays out and writes header (whose bytes[] must be filled in) followed
+    // by the arrays. The file is written next to path and renamed over it,
+    // so lists still mapping the old file keep their pages.
+    static void write(const std::string& path, Header header, const void* const (&arrays)[arrayCount]) {
+        std::memcpy(header.magic, magic, sizeof(header.magic));
+        header.version = currentVersion;
+        header.indexSize = sizeof(size_t);
+
+        uint64_t offset = alignUp(sizeof(Header));
+        for (int a = 0; a < arrayCount; ++a) {
+            header.offsets[a] = offset;
+            offset = alignUp(offset + header.bytes[a]);
+        }
+        header.fileSize = offset;
+
+        std::string temp = path + ".tmp";
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error(
+                std::string("FreeList failed to create snapshot ") + temp + ": " + std::strerror(errno)
+            );
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        uint64_t written = sizeof(Header);
+        for (int a = 0; a < arrayCount; ++a) {
+            pad(out, header.offsets[a] - written);
+            out.write(static_cast<const char*>(arrays[a]), static_cast<std::streamsize>(header.bytes[a]));
+            written = header.offsets[a] + header.bytes[a];
+        }
+        pad(out, header.fileSize - written);
+
+        out.close();
+        if (!out || !sync(temp)) {
+            ::unlink(temp.c_str());
+            throw std::runtime_error(std::string("FreeList failed to write snapshot ") + path);
+        }
+
+        if (::rename(temp.c_str(), path.c_str()) != 0) {
+            int renameErrno = errno;
+            ::unlink(temp.c_str());
+            throw std::runtime_error(
+                std::string("FreeList failed to replace snapshot ") + path + ": " + std::strerror(renameErrno)
+            );
+        }
+    }
+
+    // Maps a snapshot written for elements of the given size and alignment
+    static Mapping map(const std::string& path, FreeListMapMode mode, uint64_t valueSize, uint64_t valueAlign) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(
+                std::string("FreeList failed to open snapshot ") + path + ": " + std::strerror(errno)
+            );
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error(std::string("FreeList snapshot is truncated: ") + path);
+        }
+
+        int prot = (mode == FreeListMapMode::read_only) ? PROT_READ : PROT_READ | PROT_WRITE;
+        size_t length = static_cast<size_t>(st.st_size);
+        void* base = ::mmap(nullptr, length, prot, MAP_PRIVATE, fd, 0);
+        int mapErrno = errno;
+        ::close(fd);
+
+        if (base == MAP_FAILED) {
+            throw std::runtime_error(
+                std::string("FreeList failed to map snapshot ") + path + ": " + std::strerror(mapErrno)
+            );
+        }
+
+        Mapping mapping{base, length, static_cast<const Header*>(base)};
+        const char* problem = validate(*mapping.header, length, valueSize, valueAlign);
+        if (problem != nullptr) {
+            unmap(base, length);
+            throw std::runtime_error(std::string("FreeList snapshot ") + path + " " + problem);
+        }
+
+        return mapping;
+    }
+
+    static void unmap(void* base, size_t length) {
+        ::munmap(base, length);
+    }
+
+private:
+    static constexpr char magic[8] = {'F', 'L', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+    static uint64_t alignUp(uint64_t offset) {
+        return (offset + arrayAlign - 1) / arrayAlign * arrayAlign;
+    }
+
+    // Flushes a written file to disk before it replaces the snapshot
+    static bool sync(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+    }
+
+    static void pad(std::ofstream& out, uint64_t count) {
+        static const char zeros[64] = {};
+        while (count != 0) {
+            uint64_t chunk = count < sizeof(zeros) ? count : sizeof(zeros);
+            out.write(zeros, static_cast<std::streamsize>(chunk));
+            count -= chunk;
+        }
+    }
+
+    static const char* validate(const Header& header, uint64_t length, uint64_t valueSize, uint64_t valueAlign) {
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) return "is not a FreeList snapshot";
+        if (header.version != currentVersion) return "has an unsupported version";
+        if (header.indexSize != sizeof(size_t)) return "was written with a different index width";
+        if (header.valueSize != valueSize || header.valueAlign != valueAlign) return "holds a different element type";
+        if (header.fileSize != length) return "is truncated";
+
+        for (int a = 0; a < arrayCount; ++a) {
+            if (header.offsets[a] % arrayAlign != 0 ||
+                header.offsets[a] > length || header.bytes[a] > length - header.offsets[a]) {
+                return "has a corrupt array table";
+            }
+        }
+
+        uint64_t slots = header.slots;
+        if (header.bytes[nextArray] != slots * sizeof(size_t) ||
+            header.bytes[prevArray] != slots * sizeof(size_t) ||
+            header.bytes[freeArray] != slots * sizeof(size_t) ||
+            header.bytes[dataArray] != slots * valueSize ||
+            header.bytes[bitsArray] != (slots + 63) / 64 * sizeof(uint64_t) ||
+            header.bytes[generationsArray] > slots * sizeof(uint32_t)) {
+            return "has a corrupt array table";
+        }
+
+        if ((header.freeHead >= slots && header.freeHead != SIZE_MAX) || header.live > slots) {
+            return "has a corrupt free list";
+        }
+        return nullptr;
+    }
+};
+
+#endif